@@ -66,6 +66,18 @@
 ARGUMENTS
 #undef A
 
+// Options and enum values past the ones the C binary implements are only
+// known to the C++ build, which compiles this file with -DARGS_CPP
+#if defined(ARGS_CPP)
+#define SIZE_LIST_MODE_CHOICES SIZE_LIST_MODE_COUNT
+#define DISTRIBUTION_CHOICES DISTRIBUTION_COUNT
+#define TTL_CHOICES TTL_COUNT
+#else
+#define SIZE_LIST_MODE_CHOICES (SIZE_LIST_MODE_NEAREST + 1)
+#define DISTRIBUTION_CHOICES (DISTRIBUTION_POWERLAW + 1)
+#define TTL_CHOICES (TTL_LIST + 1)
+#endif // ARGS_CPP
+
 #pragma endregion DEFINES
 
 #pragma region GLOBALS
@@ -90,8 +102,68 @@ ArgSpec specs[] = {
     {'f', "alloc-freq", __args_set_field_alloc_freq, false, "F",
      "Frequency [0, 1] of allocations when policy not 'never'",
      "General run-control", NULL, 0, arg_float(0.7), true},
+#if defined(ARGS_CPP)
+    {'\0', "resize-freq", __args_set_field_resize_freq, false, "F",
+     "Frequency [0, 1] of resizing a live block instead of alloc/free",
+     "General run-control", NULL, 0, arg_float(0.0), true},
+#endif // ARGS_CPP
     {'s', "seed", __args_set_field_seed, false, "N", "RNG seed (0=time)",
      "General run-control", NULL, 0, arg_int(0u), true},
+#if defined(ARGS_CPP)
+    {'\0', "rng", __args_set_field_rng, false, "NAME",
+     "Generator behind Random, xoshiro ones draw 8 lanes into a buffer",
+     "General run-control", rngs, RNG_COUNT, arg_enum(RNG_XORSHIFT), true},
+    {'t', "threads", __args_set_field_threads, false, "N",
+     "Worker threads with own pool shard and RNG stream (0=single loop)",
+     "General run-control", NULL, 0, arg_int(0u), true},
+    {'\0', "processes", __args_set_field_processes, false, "N",
+     "Forked worker processes with own heap and RNG stream (0=off)",
+     "General run-control", NULL, 0, arg_int(0u), true},
+    {'\0', "scenario", __args_set_field_scenario, false, "NAME",
+     "How --threads workers (or --processes children) share blocks",
+     "General run-control", scenarios, SCENARIO_COUNT,
+     arg_enum(SCENARIO_SHARDED), true},
+    {'\0', "schedule", __args_set_field_schedule, false, "MODE",
+     "Generate the op stream ahead and only replay it in the measured loop "
+     "(chunked=generator thread runs ahead)",
+     "General run-control", schedules, SCHEDULE_COUNT,
+     arg_enum(SCHEDULE_OFF), true},
+    {'\0', "chunk-ops", __args_set_field_schedule_chunk, false, "N",
+     "Ops per buffer of the chunked schedule", "General run-control", NULL,
+     0, arg_int(65536u), true},
+    {'\0', "generic-loop", __args_set_field_generic_loop, false, NULL,
+     "Run the switch dispatched main loop instead of the one compiled for "
+     "the policy, trend, ttl mode and distribution",
+     "General run-control", NULL, 0, arg_bool(false), true},
+    {'\0', "producers", __args_set_field_producers, false, "N",
+     "Allocating threads in handoff scenario (0=half)", "General run-control",
+     NULL, 0, arg_int(0u), true},
+    {'\0', "ring-size", __args_set_field_ring_size, false, "N",
+     "Slots in each handoff ring (power of 2)", "General run-control", NULL, 0,
+     arg_int(1024u), true},
+    {'\0', "lock", __args_set_field_lock, false, "NAME",
+     "Lock of shared pool for policies without a lock-free variant",
+     "General run-control", locks, LOCK_COUNT, arg_enum(LOCK_MUTEX), true},
+    {'\0', "spawn-freq", __args_set_field_spawn_freq, false, "F",
+     "Probability [0, 1] that a steal scenario task spawns children",
+     "General run-control", NULL, 0, arg_float(0.3), true},
+    {'\0', "fanout", __args_set_field_fanout, false, "N",
+     "Children per spawning task", "General run-control", NULL, 0,
+     arg_int(2u), true},
+    {'\0', "max-depth", __args_set_field_max_depth, false, "N",
+     "Max depth of the task tree", "General run-control", NULL, 0,
+     arg_int(4u), true},
+    {'\0', "sessions", __args_set_field_sessions, false, "L[N]",
+     "Coroutine session counts to run one after another",
+     "General run-control", NULL, 0, arg_intlist, true},
+    {'\0', "session-capacity", __args_set_field_session_capacity, false, "N",
+     "Max live blocks of each session", "General run-control", NULL, 0,
+     arg_int(16u), true},
+    {'\0', "touch-freq", __args_set_field_touch_freq, false, "F",
+     "Probability [0, 1] that a cow scenario child writes to an inherited "
+     "block instead of alloc/free",
+     "General run-control", NULL, 0, arg_float(0.5), true},
+#endif // ARGS_CPP
 
     {'c', "capacity", __args_set_field_capacity, false, "C", "Max live blocks",
      "Pool sizing", NULL, 0, arg_int(10000u), true},
@@ -114,22 +186,48 @@ ArgSpec specs[] = {
      false},
     {'\0', "size-mode", __args_set_field_size_mode, false, "MODE",
      "Choose size from list. trend/distribution for nearest", "Block-size",
-     size_list_modes, SIZE_LIST_MODE_COUNT, arg_enum(SIZE_LIST_MODE_EXACT),
+     size_list_modes, SIZE_LIST_MODE_CHOICES, arg_enum(SIZE_LIST_MODE_EXACT),
      true},
     {'\0', "size-weights", __args_set_field_size_weights, false, "L[N]",
      "Set weights of size list (in %)", "Block-size", NULL, 0, arg_intlist,
      false},
+#if defined(ARGS_CPP)
+    {'\0', "markov-matrix", __args_set_field_markov_matrix, false, "L[F]",
+     "Row-major transition weights between size-list entries, counts or "
+     "probabilities (markov mode)",
+     "Block-size", NULL, 0, arg_str(NULL), true},
+    {'\0', "markov-file", __args_set_field_markov_file, false, "FILE",
+     "Transition weights like --markov-matrix, one row per line (markov "
+     "mode)",
+     "Block-size", NULL, 0, arg_str(NULL), true},
+    {'\0', "markov-trace", __args_set_field_markov_trace, false, "FILE",
+     "Fit the chain from recorded sizes, one per line (markov mode)",
+     "Block-size", NULL, 0, arg_str(NULL), true},
+#endif // ARGS_CPP
 
     {'P', "distribution", __args_set_field_distribution, false, "TYPE",
      "Size distribution", "Block-size distribution", distributions,
-     DISTRIBUTION_COUNT, arg_enum(DISTRIBUTION_UNIFORM), true},
+     DISTRIBUTION_CHOICES, arg_enum(DISTRIBUTION_UNIFORM), true},
     {'r', "dist-param", __args_set_field_dist_param, false, "F",
      "Parameter for non-uniform distributions {exp(lambda), "
      "powerlaw(alpha)}",
      "Block-size distribution", NULL, 0, arg_float(1.0f), true},
+#if defined(ARGS_CPP)
+    {'\0', "sampler", __args_set_field_sampler, false, "NAME",
+     "Draw exp/powerlaw sizes with log/pow or from an inverse-CDF table",
+     "Block-size distribution", samplers, SAMPLER_COUNT,
+     arg_enum(SAMPLER_ANALYTIC), true},
+    {'\0', "cdf-size", __args_set_field_cdf_size, false, "N",
+     "Intervals of the inverse-CDF table (KS distance <= 1/N)",
+     "Block-size distribution", NULL, 0, arg_int(4096u), true},
+    {'\0', "dist-file", __args_set_field_dist_file, false, "FILE",
+     "Size histogram (LO HI COUNT per line) or raw sizes (one per line) "
+     "for the empirical distribution",
+     "Block-size distribution", NULL, 0, arg_str(NULL), true},
+#endif // ARGS_CPP
 
     {'\0', "ttl-mode", __args_set_field_ttl_mode, false, "MODE",
-     "Set lifetime of blocks", "Block lifetime", ttls, TTL_COUNT,
+     "Set lifetime of blocks", "Block lifetime", ttls, TTL_CHOICES,
      arg_enum(TTL_OFF), true},
     {'\0', "ttl-fixed", __args_set_field_ttl_fixed, false, "N",
      "Number of cycles blocks will live", "Block lifetime", NULL, 0,
@@ -140,6 +238,57 @@ ArgSpec specs[] = {
     {'\0', "ttl-weights", __args_set_field_ttl_weights, false, "L[N]",
      "Set weights for list of lifetimes", "Block lifetime", NULL, 0,
      arg_intlist, true},
+#if defined(ARGS_CPP)
+    {'\0', "ttl-min", __args_set_field_ttl_min, false, "N",
+     "Shortest lifetime of exp/powerlaw ttl modes", "Block lifetime", NULL, 0,
+     arg_int(1u), true},
+    {'\0', "ttl-max", __args_set_field_ttl_max, false, "N",
+     "Longest lifetime of exp/powerlaw ttl modes", "Block lifetime", NULL, 0,
+     arg_int(10000u), true},
+    {'\0', "ttl-param", __args_set_field_ttl_param, false, "F",
+     "Parameter of ttl distribution {exp(lambda), powerlaw(alpha)}",
+     "Block lifetime", NULL, 0, arg_float(0.01), true},
+    {'\0', "ttl-file", __args_set_field_ttl_file, false, "FILE",
+     "Lifetime histogram or raw lifetimes for the empirical ttl mode "
+     "(same format as --dist-file)",
+     "Block lifetime", NULL, 0, arg_str(NULL), true},
+    {'\0', "ttl-corr", __args_set_field_ttl_corr, false, "F",
+     "Rank correlation [-1, 1] between block size and lifetime "
+     "(exp/powerlaw/empirical ttl modes)",
+     "Block lifetime", NULL, 0, arg_float(0.0), true},
+    {'\0', "sites", __args_set_field_sites, false, "FILE",
+     "Allocation sites, one per line with own rate, size, ttl and policy",
+     "Allocation sites", NULL, 0, arg_str(NULL), true},
+
+    {'\0', "huge-pages", __args_set_field_huge_pages, false, "MODE",
+     "Back large blocks with huge pages", "Memory backend", huge_pages,
+     HUGE_PAGES_COUNT, arg_enum(HUGE_PAGES_OFF), true},
+    {'\0', "huge-threshold", __args_set_field_huge_threshold, false, "BYTES",
+     "Min block size mapped with --huge-pages", "Memory backend", NULL, 0,
+     arg_size(2u << 20), true},
+    {'\0', "release", __args_set_field_release, false, "MODE",
+     "Return memory of freed blocks to the OS", "Memory backend", releases,
+     RELEASE_COUNT, arg_enum(RELEASE_OFF), true},
+    {'\0', "madvise-min", __args_set_field_madvise_min, false, "BYTES",
+     "Min freed block size for madvise releases", "Memory backend", NULL, 0,
+     arg_size(64u << 10), true},
+    {'\0', "trim-interval", __args_set_field_trim_interval, false, "N",
+     "Call malloc_trim every N ops (0=off)", "Memory backend", NULL, 0,
+     arg_int(0), true},
+    {'\0', "trim-threshold", __args_set_field_trim_threshold, false, "BYTES",
+     "Call malloc_trim after this many freed bytes (0=off)", "Memory backend",
+     NULL, 0, arg_size(0), true},
+    {'\0', "reclaim", __args_set_field_reclaim, false, "MODE",
+     "When freed blocks are destroyed (thread=background reclaimer)",
+     "Memory backend", reclaims, RECLAIM_COUNT, arg_enum(RECLAIM_IMMEDIATE),
+     true},
+    {'\0', "epoch-length", __args_set_field_epoch_length, false, "N",
+     "Free retired blocks every N iterations in epoch mode (0=off)",
+     "Memory backend", NULL, 0, arg_int(1000u), true},
+    {'\0', "retire-limit", __args_set_field_retire_limit, false, "BYTES",
+     "Also free once a thread retired this many bytes (0=off)",
+     "Memory backend", NULL, 0, arg_size(0), true},
+#endif // ARGS_CPP
 
     {'i', "snap-interval", __args_set_field_snap_interval, false, "N",
      "Every N ops, snapshot and log stats", "Instrumentation & output", NULL, 0,
@@ -147,6 +296,19 @@ ArgSpec specs[] = {
     {'o', "output", __args_set_field_output, false, "FILE",
      "Path to CSV metrics log", "Instrumentation & output", NULL, 0,
      arg_str(NULL), true},
+#if defined(ARGS_CPP)
+    {'\0', "slack-output", __args_set_field_slack_output, false, "FILE",
+     "Path to CSV of allocator slack per size class, also fills the usable "
+     "size columns of --output (one malloc_usable_size per operation)",
+     "Instrumentation & output", NULL, 0, arg_str(NULL), true},
+    {'\0', "tracking", __args_set_field_tracking, false, "MODE",
+     "Where allocation accounting runs (async=aggregator thread)",
+     "Instrumentation & output", trackings, TRACKING_COUNT,
+     arg_enum(TRACKING_INLINE), true},
+    {'\0', "event-ring", __args_set_field_event_ring, false, "N",
+     "Per-thread event ring slots in async tracking (power of 2)",
+     "Instrumentation & output", NULL, 0, arg_int(4096u), true},
+#endif // ARGS_CPP
     {'\0', "display", __args_set_field_display, false, NULL,
      "Display a progress bar", "Instrumentation & output", NULL, 0,
      arg_bool(false), true},
@@ -205,7 +367,7 @@ int parse_enum(const char *argval, ArgSpec *spec) {
         }
     }
 
-    fatal("Invalid enum option: %s", argval);
+    fatal("Invalid enum option for --%s: %s", spec->long_opt, argval);
 }
 
 Int parse_duration(const char *argval) {
@@ -330,6 +492,9 @@ IntList parse_size_list(const char *argval) {
 #pragma region MAIN FUNCS
 
 static void check_args(Args *args, Int iter);
+#if defined(ARGS_CPP)
+static void check_cpp_args(Args *args);
+#endif // ARGS_CPP
 
 static char size_buf[1024];
 static char prec_buf[16];
@@ -387,44 +552,44 @@ void print_usage(const char *progname, const ArgSpec *specs,
             strcat(enumlist, "; one of:");
         }
 
-        println("  %-4s--%-13s%-9s %s%s", shortbuf, s->long_opt, metavar,
+        println("  %-4s--%-16s%-9s %s%s", shortbuf, s->long_opt, metavar,
                 s->help, enumlist);
 
         if (s->has_default) {
             switch (spec_type(*s)) {
             case ARG_TYPE_BOOL:
-                println("%32s (default: %s)", "",
+                println("%35s (default: %s)", "",
                         (s->default_val.as.b) ? "true" : "false");
                 break;
             case ARG_TYPE_FLOAT:
-                println("%32s (default: %.2f)", "", s->default_val.as.f);
+                println("%35s (default: %.2f)", "", s->default_val.as.f);
                 break;
             case ARG_TYPE_INT:
-                println("%32s (default: %lu)", "", s->default_val.as.i);
+                println("%35s (default: %lu)", "", s->default_val.as.i);
                 break;
             case ARG_TYPE_TIME:
                 if (s->default_val.as.i < 60) {
-                    println("%32s (default: %lus)", "", s->default_val.as.i);
+                    println("%35s (default: %lus)", "", s->default_val.as.i);
                 } else if (s->default_val.as.i % 60 == 0) {
-                    println("%32s (default: %lumin)", "",
+                    println("%35s (default: %lumin)", "",
                             s->default_val.as.i / 60);
                 } else {
-                    println("%32s (default: %lumin %lus)", "",
+                    println("%35s (default: %lumin %lus)", "",
                             s->default_val.as.i / 60, s->default_val.as.i % 60);
                 }
                 break;
             case ARG_TYPE_SIZE:
-                println("%32s (default: %s)", "",
+                println("%35s (default: %s)", "",
                         size_str(s->default_val.as.i, 1));
                 break;
             case ARG_TYPE_STR:
                 if (s->default_val.as.s != NULL) {
-                    println("%32s (default: %s)", "", s->default_val.as.s);
+                    println("%35s (default: %s)", "", s->default_val.as.s);
                 }
                 break;
             case ARG_TYPE_ENUM:
                 for (usize i = 0; i < s->choices_count; i++) {
-                    println("%32s - %s%s", "", s->choices[i],
+                    println("%35s - %s%s", "", s->choices[i],
                             (i == s->default_val.as.i) ? " (default)" : "");
                 }
                 break;
@@ -526,9 +691,12 @@ void parse_args(int argc, char **argv, Args *args, ArgSpec *specs,
                 break;
             }
 
+            // only --name=value, a bare prefix would let --release swallow
+            // every longer option that starts with it
             usize opt_len = strlen(specs[j].long_opt);
             if ((*(arg + 1) == '-') &&
-                (strncmp(arg + 2, specs[j].long_opt, opt_len) == 0)) {
+                (strncmp(arg + 2, specs[j].long_opt, opt_len) == 0) &&
+                (*(arg + 2 + opt_len) == '=')) {
                 off = opt_len + 2;
                 i = j;
                 break;
@@ -616,8 +784,189 @@ static void check_args(Args *args, Int iter) {
         fatal("--alloc-freq should be on the interval [0, 1], but is %f",
               args->alloc_freq.as.f);
     }
+
+#if defined(ARGS_CPP)
+    check_cpp_args(args);
+#endif // ARGS_CPP
 }
 
+#if defined(ARGS_CPP)
+static void check_cpp_args(Args *args) {
+    if (args->cdf_size.as.i == 0) {
+        fatal("--cdf-size should not be zero");
+    }
+
+    if ((args->distribution.as.e == DISTRIBUTION_EMPIRICAL) &&
+        (args->dist_file.as.s == NULL)) {
+        fatal("Empirical distribution needs --dist-file");
+    }
+
+    if (args->size_mode.as.e == SIZE_LIST_MODE_MARKOV) {
+        u32 sources = (args->markov_matrix.as.s != NULL) +
+                      (args->markov_file.as.s != NULL) +
+                      (args->markov_trace.as.s != NULL);
+        if (sources != 1) {
+            fatal("Markov size mode needs exactly one of --markov-matrix, "
+                  "--markov-file and --markov-trace");
+        }
+
+        u32 n = args->size_list.as.il.count;
+        if ((args->markov_trace.as.s == NULL) && (n == 0)) {
+            fatal("Markov transition weights need a --size-list");
+        }
+    }
+
+    if ((args->processes.as.i > 0) && (args->threads.as.i > 0)) {
+        fatal("Arguments --processes and --threads are mutualy exclusive");
+    }
+
+    // background threads of the parent do not survive fork
+    if ((args->processes.as.i > 0) &&
+        ((args->reclaim.as.e == RECLAIM_THREAD) ||
+         (args->tracking.as.e != TRACKING_INLINE))) {
+        fatal("--processes needs --reclaim other than 'thread' and "
+              "--tracking 'inline'");
+    }
+
+    if ((args->scenario.as.e == SCENARIO_HANDOFF) &&
+        (args->threads.as.i < 2)) {
+        fatal("Scenario 'handoff' needs --threads of at least 2");
+    }
+
+    if ((args->scenario.as.e == SCENARIO_HANDOFF) &&
+        (args->producers.as.i >= args->threads.as.i)) {
+        fatal("--producers should leave at least one consuming thread");
+    }
+
+    if ((args->scenario.as.e == SCENARIO_SHARED) &&
+        (args->threads.as.i == 0)) {
+        fatal("Scenario 'shared' needs --threads");
+    }
+
+    if ((args->scenario.as.e == SCENARIO_STEAL) &&
+        (args->threads.as.i == 0)) {
+        fatal("Scenario 'steal' needs --threads");
+    }
+
+    if ((args->ring_size.as.i == 0) ||
+        ((args->ring_size.as.i & (args->ring_size.as.i - 1)) != 0)) {
+        fatal("--ring-size should be a power of 2");
+    }
+
+    if ((args->event_ring.as.i == 0) ||
+        ((args->event_ring.as.i & (args->event_ring.as.i - 1)) != 0)) {
+        fatal("--event-ring should be a power of 2");
+    }
+
+    if (args->spawn_freq.as.f < 0 || args->spawn_freq.as.f > 1) {
+        fatal("--spawn-freq should be on the interval [0, 1], but is %f",
+              args->spawn_freq.as.f);
+    }
+
+    if (args->fanout.as.i == 0) {
+        fatal("--fanout should not be zero");
+    }
+
+    if ((args->scenario.as.e == SCENARIO_SESSIONS) &&
+        ((args->sessions.as.il.count == 0) || (args->threads.as.i == 0))) {
+        fatal("Scenario 'sessions' needs --threads and a list of --sessions");
+    }
+
+    for (u32 i = 0; i < args->sessions.as.il.count; i++) {
+        if (args->sessions.as.il.items[i] == 0) {
+            fatal("--sessions should not contain zero");
+        }
+    }
+
+    if (args->session_capacity.as.i == 0) {
+        fatal("--session-capacity should not be zero");
+    }
+
+    if ((args->scenario.as.e == SCENARIO_COW) &&
+        (args->processes.as.i == 0)) {
+        fatal("Scenario 'cow' needs --processes");
+    }
+
+    if (args->touch_freq.as.f < 0 || args->touch_freq.as.f > 1) {
+        fatal("--touch-freq should be on the interval [0, 1], but is %f",
+              args->touch_freq.as.f);
+    }
+
+    if ((args->ttl_min.as.i == 0) ||
+        (args->ttl_min.as.i > args->ttl_max.as.i)) {
+        fatal("--ttl-min should be positive and not above --ttl-max");
+    }
+
+    if (((args->ttl_mode.as.e == TTL_EXP) ||
+         (args->ttl_mode.as.e == TTL_POWERLAW)) &&
+        (args->ttl_param.as.f == 0.0)) {
+        fatal("--ttl-param should not be 0");
+    }
+
+    if ((args->ttl_mode.as.e == TTL_EMPIRICAL) &&
+        (args->ttl_file.as.s == NULL)) {
+        fatal("Empirical ttl mode needs --ttl-file");
+    }
+
+    if (args->ttl_corr.as.f < -1 || args->ttl_corr.as.f > 1) {
+        fatal("--ttl-corr should be on the interval [-1, 1], but is %f",
+              args->ttl_corr.as.f);
+    }
+
+    if ((args->ttl_corr.as.f != 0.0) && (args->ttl_mode.as.e != TTL_EXP) &&
+        (args->ttl_mode.as.e != TTL_POWERLAW) &&
+        (args->ttl_mode.as.e != TTL_EMPIRICAL)) {
+        fatal("--ttl-corr needs --ttl-mode exp, powerlaw or empirical");
+    }
+
+    if ((args->schedule.as.e != SCHEDULE_OFF) &&
+        ((args->threads.as.i > 0) || (args->processes.as.i > 0) ||
+         (args->sites.as.s != NULL))) {
+        fatal("--schedule needs the single threaded loop without --sites");
+    }
+
+    if ((args->schedule.as.e == SCHEDULE_FULL) &&
+        (args->duration_sec.as.i > 0)) {
+        fatal("A full --schedule needs --iterations, use 'chunked' with "
+              "--duration");
+    }
+
+    if (args->schedule_chunk.as.i == 0) {
+        fatal("--chunk-ops should not be zero");
+    }
+
+    // frees are charged to the site whose pool is being worked on, so they
+    // have to happen right there on the one worker
+    if ((args->sites.as.s != NULL) &&
+        ((args->threads.as.i > 0) || (args->processes.as.i > 0) ||
+         (args->reclaim.as.e != RECLAIM_IMMEDIATE))) {
+        fatal("--sites needs the single threaded loop and --reclaim "
+              "'immediate'");
+    }
+
+    if ((args->huge_pages.as.e != HUGE_PAGES_OFF) &&
+        (args->huge_threshold.as.i == 0)) {
+        fatal("--huge-threshold should not be zero");
+    }
+
+    if ((args->release.as.e == RELEASE_TRIM) &&
+        (args->trim_interval.as.i == 0) && (args->trim_threshold.as.i == 0)) {
+        fatal("If --release is 'trim', then --trim-interval or "
+              "--trim-threshold should be set");
+    }
+
+    if ((args->reclaim.as.e == RECLAIM_EPOCH) &&
+        (args->epoch_length.as.i == 0) && (args->retire_limit.as.i == 0)) {
+        fatal("If --reclaim is 'epoch', then --epoch-length or "
+              "--retire-limit should be set");
+    }
+
+    if (args->resize_freq.as.f < 0 || args->resize_freq.as.f > 1) {
+        fatal("--resize-freq should be on the interval [0, 1], but is %f",
+              args->resize_freq.as.f);
+    }
+}
+#endif // ARGS_CPP
 #define A(name)                                                                \
     if (((args->name.t == ARG_TYPE_INT_LIST) ||                                \
          (args->name.t == ARG_TYPE_SIZE_LIST)) &&                              \
@@ -671,7 +1020,40 @@ void log_args(const Args *args) {
     log_debug("args.iterations = %zu", args->iterations.as.i);
     log_debug("args.duration_sec = %zu", args->duration_sec.as.i);
     log_debug("args.alloc_freq = %f", args->alloc_freq.as.f);
+    log_debug("args.resize_freq = %f", args->resize_freq.as.f);
     log_debug("args.seed = %zu", args->seed.as.i);
+    if (args->rng.as.e >= RNG_COUNT) {
+        log_debug("args.rng = unknown(%u)", args->rng.as.e);
+    } else {
+        log_debug("args.rng = %s", rngs[args->rng.as.e]);
+    }
+    log_debug("args.threads = %zu", args->threads.as.i);
+    log_debug("args.processes = %zu", args->processes.as.i);
+    if (args->scenario.as.e >= SCENARIO_COUNT) {
+        log_debug("args.scenario = unknown(%u)", args->scenario.as.e);
+    } else {
+        log_debug("args.scenario = %s", scenarios[args->scenario.as.e]);
+    }
+    if (args->schedule.as.e >= SCHEDULE_COUNT) {
+        log_debug("args.schedule = unknown(%u)", args->schedule.as.e);
+    } else {
+        log_debug("args.schedule = %s", schedules[args->schedule.as.e]);
+    }
+    log_debug("args.schedule_chunk = %zu", args->schedule_chunk.as.i);
+    log_debug("args.generic_loop = %d", args->generic_loop.as.b);
+    log_debug("args.producers = %zu", args->producers.as.i);
+    log_debug("args.ring_size = %zu", args->ring_size.as.i);
+    if (args->lock.as.e >= LOCK_COUNT) {
+        log_debug("args.lock = unknown(%u)", args->lock.as.e);
+    } else {
+        log_debug("args.lock = %s", locks[args->lock.as.e]);
+    }
+    log_debug("args.spawn_freq = %f", args->spawn_freq.as.f);
+    log_debug("args.fanout = %zu", args->fanout.as.i);
+    log_debug("args.max_depth = %zu", args->max_depth.as.i);
+    log_debug("args.sessions = %s", str_int_list(&args->sessions.as.il));
+    log_debug("args.session_capacity = %zu", args->session_capacity.as.i);
+    log_debug("args.touch_freq = %f", args->touch_freq.as.f);
 
     log_debug("args.capacity = %zu", args->capacity.as.i);
 
@@ -694,6 +1076,9 @@ void log_args(const Args *args) {
     }
     log_debug("args.size_weights = %s",
               str_int_list(&args->size_weights.as.il));
+    log_debug("args.markov_matrix = %s", args->markov_matrix.as.s);
+    log_debug("args.markov_file = %s", args->markov_file.as.s);
+    log_debug("args.markov_trace = %s", args->markov_trace.as.s);
 
     if (args->distribution.as.e >= DISTRIBUTION_COUNT) {
         log_debug("args.distribution = unknown(%u)", args->distribution.as.e);
@@ -703,6 +1088,13 @@ void log_args(const Args *args) {
     }
 
     log_debug("args.dist_param = %f", args->dist_param.as.f);
+    if (args->sampler.as.e >= SAMPLER_COUNT) {
+        log_debug("args.sampler = unknown(%u)", args->sampler.as.e);
+    } else {
+        log_debug("args.sampler = %s", samplers[args->sampler.as.e]);
+    }
+    log_debug("args.cdf_size = %zu", args->cdf_size.as.i);
+    log_debug("args.dist_file = %s", args->dist_file.as.s);
 
     if (args->ttl_mode.as.e >= TTL_COUNT) {
         log_debug("args.ttl_mode = unknown(%u)", args->ttl_mode.as.e);
@@ -712,9 +1104,44 @@ void log_args(const Args *args) {
     log_debug("args.ttl_fixed = %zu", args->ttl_fixed.as.i);
     log_debug("args.ttl_list = %s", str_int_list(&args->ttl_list.as.il));
     log_debug("args.ttl_weights = %s", str_int_list(&args->ttl_weights.as.il));
+    log_debug("args.ttl_min = %zu", args->ttl_min.as.i);
+    log_debug("args.ttl_max = %zu", args->ttl_max.as.i);
+    log_debug("args.ttl_param = %f", args->ttl_param.as.f);
+    log_debug("args.ttl_file = %s", args->ttl_file.as.s);
+    log_debug("args.ttl_corr = %f", args->ttl_corr.as.f);
+    log_debug("args.sites = %s", args->sites.as.s);
+
+    if (args->huge_pages.as.e >= HUGE_PAGES_COUNT) {
+        log_debug("args.huge_pages = unknown(%u)", args->huge_pages.as.e);
+    } else {
+        log_debug("args.huge_pages = %s", huge_pages[args->huge_pages.as.e]);
+    }
+    log_debug("args.huge_threshold = %zu", args->huge_threshold.as.i);
+    if (args->release.as.e >= RELEASE_COUNT) {
+        log_debug("args.release = unknown(%u)", args->release.as.e);
+    } else {
+        log_debug("args.release = %s", releases[args->release.as.e]);
+    }
+    log_debug("args.madvise_min = %zu", args->madvise_min.as.i);
+    log_debug("args.trim_interval = %zu", args->trim_interval.as.i);
+    log_debug("args.trim_threshold = %zu", args->trim_threshold.as.i);
+    if (args->reclaim.as.e >= RECLAIM_COUNT) {
+        log_debug("args.reclaim = unknown(%u)", args->reclaim.as.e);
+    } else {
+        log_debug("args.reclaim = %s", reclaims[args->reclaim.as.e]);
+    }
+    log_debug("args.epoch_length = %zu", args->epoch_length.as.i);
+    log_debug("args.retire_limit = %zu", args->retire_limit.as.i);
 
     log_debug("args.snap_interval = %zu", args->snap_interval.as.i);
     log_debug("args.output = %s", args->output.as.s);
+    log_debug("args.slack_output = %s", args->slack_output.as.s);
+    if (args->tracking.as.e >= TRACKING_COUNT) {
+        log_debug("args.tracking = unknown(%u)", args->tracking.as.e);
+    } else {
+        log_debug("args.tracking = %s", trackings[args->tracking.as.e]);
+    }
+    log_debug("args.event_ring = %zu", args->event_ring.as.i);
     log_debug("args.display = %d", args->display.as.b);
 }
 
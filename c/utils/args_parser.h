@@ -20,7 +20,24 @@ extern "C" {
     A(iterations)                                                              \
     A(duration_sec)                                                            \
     A(alloc_freq)                                                              \
+    A(resize_freq)                                                             \
     A(seed)                                                                    \
+    A(rng)                                                                     \
+    A(threads)                                                                 \
+    A(processes)                                                               \
+    A(scenario)                                                                \
+    A(schedule)                                                                \
+    A(schedule_chunk)                                                          \
+    A(generic_loop)                                                            \
+    A(producers)                                                               \
+    A(ring_size)                                                               \
+    A(lock)                                                                    \
+    A(spawn_freq)                                                              \
+    A(fanout)                                                                  \
+    A(max_depth)                                                               \
+    A(sessions)                                                                \
+    A(session_capacity)                                                        \
+    A(touch_freq)                                                              \
     /* Pool */                                                                 \
     A(capacity)                                                                \
     /* Block size */                                                           \
@@ -30,19 +47,44 @@ extern "C" {
     A(size_list)                                                               \
     A(size_mode)                                                               \
     A(size_weights)                                                            \
+    A(markov_matrix)                                                           \
+    A(markov_file)                                                             \
+    A(markov_trace)                                                            \
     A(min_size)                                                                \
     A(max_size)                                                                \
     /* Block size distribution */                                              \
     A(distribution)                                                            \
     A(dist_param)                                                              \
+    A(sampler)                                                                 \
+    A(cdf_size)                                                                \
+    A(dist_file)                                                               \
     /* Block lifetimes*/                                                       \
     A(ttl_mode)                                                                \
     A(ttl_fixed)                                                               \
     A(ttl_list)                                                                \
     A(ttl_weights)                                                                 \
+    A(ttl_min)                                                                 \
+    A(ttl_max)                                                                 \
+    A(ttl_param)                                                               \
+    A(ttl_file)                                                                \
+    A(ttl_corr)                                                                \
+    A(sites)                                                                   \
+    /* Memory backend */                                                       \
+    A(huge_pages)                                                              \
+    A(huge_threshold)                                                          \
+    A(release)                                                                 \
+    A(madvise_min)                                                             \
+    A(trim_interval)                                                           \
+    A(trim_threshold)                                                          \
+    A(reclaim)                                                                 \
+    A(epoch_length)                                                            \
+    A(retire_limit)                                                            \
     /* Instrumentation & output */                                             \
     A(snap_interval)                                                           \
     A(output)                                                                  \
+    A(slack_output)                                                            \
+    A(tracking)                                                                \
+    A(event_ring)                                                              \
     A(display)
 
 typedef enum {
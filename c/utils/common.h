@@ -148,6 +148,7 @@ typedef enum {
     DISTRIBUTION_UNIFORM,
     DISTRIBUTION_EXP,
     DISTRIBUTION_POWERLAW,
+    DISTRIBUTION_EMPIRICAL,
     DISTRIBUTION_COUNT
 } Distribution;
 
@@ -162,6 +163,7 @@ inline constexpr auto __distributions = []() constexpr {
     d[DISTRIBUTION_UNIFORM] = "uniform";
     d[DISTRIBUTION_EXP] = "exp";
     d[DISTRIBUTION_POWERLAW] = "powerlaw";
+    d[DISTRIBUTION_EMPIRICAL] = "empirical";
 
     return d;
 }();
@@ -173,7 +175,8 @@ extern "C" {
 
 static const char *distributions[] = {[DISTRIBUTION_UNIFORM] = "uniform",
                                       [DISTRIBUTION_EXP] = "exp",
-                                      [DISTRIBUTION_POWERLAW] = "powerlaw"};
+                                      [DISTRIBUTION_POWERLAW] = "powerlaw",
+                                      [DISTRIBUTION_EMPIRICAL] = "empirical"};
 
 #endif // __cplusplus
 
@@ -218,6 +221,7 @@ static const char *trends[] = {
 typedef enum {
     SIZE_LIST_MODE_EXACT,
     SIZE_LIST_MODE_NEAREST,
+    SIZE_LIST_MODE_MARKOV,
     SIZE_LIST_MODE_COUNT,
 } SizeListMode;
 
@@ -231,6 +235,7 @@ inline constexpr auto __size_list_modes = []() constexpr {
 
     m[SIZE_LIST_MODE_EXACT] = "exact";
     m[SIZE_LIST_MODE_NEAREST] = "nearest";
+    m[SIZE_LIST_MODE_MARKOV] = "markov";
 
     return m;
 }();
@@ -243,6 +248,7 @@ extern "C" {
 static const char *size_list_modes[] = {
     [SIZE_LIST_MODE_EXACT] = "exact",
     [SIZE_LIST_MODE_NEAREST] = "nearest",
+    [SIZE_LIST_MODE_MARKOV] = "markov",
 };
 
 #endif // __cplusplus
@@ -251,6 +257,9 @@ typedef enum {
     TTL_OFF,
     TTL_FIXED,
     TTL_LIST,
+    TTL_EXP,
+    TTL_POWERLAW,
+    TTL_EMPIRICAL,
     TTL_COUNT,
 } Lifetime;
 
@@ -265,6 +274,9 @@ inline constexpr auto __ttls = []() constexpr {
     l[TTL_OFF] = "off";
     l[TTL_FIXED] = "fixed";
     l[TTL_LIST] = "list";
+    l[TTL_EXP] = "exp";
+    l[TTL_POWERLAW] = "powerlaw";
+    l[TTL_EMPIRICAL] = "empirical";
 
     return l;
 }();
@@ -278,6 +290,330 @@ static const char *ttls[] = {
     [TTL_OFF] = "off",
     [TTL_FIXED] = "fixed",
     [TTL_LIST] = "list",
+    [TTL_EXP] = "exp",
+    [TTL_POWERLAW] = "powerlaw",
+    [TTL_EMPIRICAL] = "empirical",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    HUGE_PAGES_OFF,
+    HUGE_PAGES_MADVISE,
+    HUGE_PAGES_HUGETLB,
+    HUGE_PAGES_COUNT,
+} HugePages;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __huge_pages = []() constexpr {
+    std::array<const char *, HUGE_PAGES_COUNT> h{};
+
+    h[HUGE_PAGES_OFF] = "off";
+    h[HUGE_PAGES_MADVISE] = "madvise";
+    h[HUGE_PAGES_HUGETLB] = "hugetlb";
+
+    return h;
+}();
+
+inline constexpr auto huge_pages = __huge_pages.data();
+
+extern "C" {
+#else
+
+static const char *huge_pages[] = {
+    [HUGE_PAGES_OFF] = "off",
+    [HUGE_PAGES_MADVISE] = "madvise",
+    [HUGE_PAGES_HUGETLB] = "hugetlb",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    RELEASE_OFF,
+    RELEASE_DONTNEED,
+    RELEASE_FREE,
+    RELEASE_TRIM,
+    RELEASE_COUNT,
+} Release;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __releases = []() constexpr {
+    std::array<const char *, RELEASE_COUNT> r{};
+
+    r[RELEASE_OFF] = "off";
+    r[RELEASE_DONTNEED] = "dontneed";
+    r[RELEASE_FREE] = "free";
+    r[RELEASE_TRIM] = "trim";
+
+    return r;
+}();
+
+inline constexpr auto releases = __releases.data();
+
+extern "C" {
+#else
+
+static const char *releases[] = {
+    [RELEASE_OFF] = "off",
+    [RELEASE_DONTNEED] = "dontneed",
+    [RELEASE_FREE] = "free",
+    [RELEASE_TRIM] = "trim",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    SCENARIO_SHARDED,
+    SCENARIO_HANDOFF,
+    SCENARIO_SHARED,
+    SCENARIO_STEAL,
+    SCENARIO_SESSIONS,
+    SCENARIO_COW,
+    SCENARIO_COUNT,
+} Scenario;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __scenarios = []() constexpr {
+    std::array<const char *, SCENARIO_COUNT> s{};
+
+    s[SCENARIO_SHARDED] = "sharded";
+    s[SCENARIO_HANDOFF] = "handoff";
+    s[SCENARIO_SHARED] = "shared";
+    s[SCENARIO_STEAL] = "steal";
+    s[SCENARIO_SESSIONS] = "sessions";
+    s[SCENARIO_COW] = "cow";
+
+    return s;
+}();
+
+inline constexpr auto scenarios = __scenarios.data();
+
+extern "C" {
+#else
+
+static const char *scenarios[] = {
+    [SCENARIO_SHARDED] = "sharded",
+    [SCENARIO_HANDOFF] = "handoff",
+    [SCENARIO_SHARED] = "shared",
+    [SCENARIO_STEAL] = "steal",
+    [SCENARIO_SESSIONS] = "sessions",
+    [SCENARIO_COW] = "cow",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    LOCK_MUTEX,
+    LOCK_SPIN,
+    LOCK_COUNT,
+} Lock;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __locks = []() constexpr {
+    std::array<const char *, LOCK_COUNT> l{};
+
+    l[LOCK_MUTEX] = "mutex";
+    l[LOCK_SPIN] = "spin";
+
+    return l;
+}();
+
+inline constexpr auto locks = __locks.data();
+
+extern "C" {
+#else
+
+static const char *locks[] = {
+    [LOCK_MUTEX] = "mutex",
+    [LOCK_SPIN] = "spin",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    TRACKING_INLINE,
+    TRACKING_ASYNC,
+    TRACKING_ASYNC_DROP,
+    TRACKING_COUNT,
+} Tracking;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __trackings = []() constexpr {
+    std::array<const char *, TRACKING_COUNT> t{};
+
+    t[TRACKING_INLINE] = "inline";
+    t[TRACKING_ASYNC] = "async";
+    t[TRACKING_ASYNC_DROP] = "async-drop";
+
+    return t;
+}();
+
+inline constexpr auto trackings = __trackings.data();
+
+extern "C" {
+#else
+
+static const char *trackings[] = {
+    [TRACKING_INLINE] = "inline",
+    [TRACKING_ASYNC] = "async",
+    [TRACKING_ASYNC_DROP] = "async-drop",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    RECLAIM_IMMEDIATE,
+    RECLAIM_THREAD,
+    RECLAIM_EPOCH,
+    RECLAIM_COUNT,
+} Reclaim;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __reclaims = []() constexpr {
+    std::array<const char *, RECLAIM_COUNT> r{};
+
+    r[RECLAIM_IMMEDIATE] = "immediate";
+    r[RECLAIM_THREAD] = "thread";
+    r[RECLAIM_EPOCH] = "epoch";
+
+    return r;
+}();
+
+inline constexpr auto reclaims = __reclaims.data();
+
+extern "C" {
+#else
+
+static const char *reclaims[] = {
+    [RECLAIM_IMMEDIATE] = "immediate",
+    [RECLAIM_THREAD] = "thread",
+    [RECLAIM_EPOCH] = "epoch",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    RNG_XORSHIFT,
+    RNG_XOSHIRO,
+    RNG_XOSHIRO_AVX2,
+    RNG_COUNT,
+} Rng;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __rngs = []() constexpr {
+    std::array<const char *, RNG_COUNT> r{};
+
+    r[RNG_XORSHIFT] = "xorshift";
+    r[RNG_XOSHIRO] = "xoshiro";
+    r[RNG_XOSHIRO_AVX2] = "xoshiro-avx2";
+
+    return r;
+}();
+
+inline constexpr auto rngs = __rngs.data();
+
+extern "C" {
+#else
+
+static const char *rngs[] = {
+    [RNG_XORSHIFT] = "xorshift",
+    [RNG_XOSHIRO] = "xoshiro",
+    [RNG_XOSHIRO_AVX2] = "xoshiro-avx2",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    SAMPLER_ANALYTIC,
+    SAMPLER_TABLE,
+    SAMPLER_COUNT,
+} Sampler;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __samplers = []() constexpr {
+    std::array<const char *, SAMPLER_COUNT> s{};
+
+    s[SAMPLER_ANALYTIC] = "analytic";
+    s[SAMPLER_TABLE] = "table";
+
+    return s;
+}();
+
+inline constexpr auto samplers = __samplers.data();
+
+extern "C" {
+#else
+
+static const char *samplers[] = {
+    [SAMPLER_ANALYTIC] = "analytic",
+    [SAMPLER_TABLE] = "table",
+};
+
+#endif // __cplusplus
+
+typedef enum {
+    SCHEDULE_OFF,
+    SCHEDULE_FULL,
+    SCHEDULE_CHUNKED,
+    SCHEDULE_COUNT,
+} Schedule;
+
+#if defined(__cplusplus)
+}
+
+#include <array>
+
+inline constexpr auto __schedules = []() constexpr {
+    std::array<const char *, SCHEDULE_COUNT> s{};
+
+    s[SCHEDULE_OFF] = "off";
+    s[SCHEDULE_FULL] = "full";
+    s[SCHEDULE_CHUNKED] = "chunked";
+
+    return s;
+}();
+
+inline constexpr auto schedules = __schedules.data();
+
+extern "C" {
+#else
+
+static const char *schedules[] = {
+    [SCHEDULE_OFF] = "off",
+    [SCHEDULE_FULL] = "full",
+    [SCHEDULE_CHUNKED] = "chunked",
 };
 
 #pragma GCC diagnostic pop
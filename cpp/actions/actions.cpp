@@ -3,10 +3,162 @@
 #include "../../c/utils/args_parser.h"
 #include "../../c/utils/list.h"
 
-static Int block_size_tmp = 0;
+#include "../random/alias.hpp"
+#include "../random/empirical.hpp"
+#include "../random/inverse_cdf.hpp"
+#include "../random/markov.hpp"
+
+#include "../backend/backend.hpp"
+#include "../reclaim/reclaim.hpp"
+#include "../tracker/tracker.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+// Trend position, every worker thread follows its own trend. Markov size
+// mode keeps the current state here instead
+static thread_local Int block_size_tmp = 0;
+
+static constexpr Int MARKOV_START = (Int)-1; // no state drawn yet
 
 namespace action {
 
+/// Size list sorted by value for NEAREST mode. `first` keeps the position
+/// in the list, so ties go to the earlier entry like a linear scan would
+struct NearestIndex {
+    std::vector<Int> sorted;
+    std::vector<usize> first;
+
+    NearestIndex() = default;
+
+    explicit NearestIndex(const IntList &l) {
+        std::vector<std::pair<Int, usize>> entries;
+        for (usize i = 0; i < l.count; i++) {
+            entries.push_back({l.items[i], i});
+        }
+        std::sort(entries.begin(), entries.end());
+
+        for (const auto &[value, idx] : entries) {
+            if (sorted.empty() || sorted.back() != value) {
+                sorted.push_back(value);
+                first.push_back(idx);
+            }
+        }
+    }
+
+    Int closest(Int size) const {
+        if (sorted.empty()) {
+            return size;
+        }
+
+        usize hi = std::lower_bound(sorted.begin(), sorted.end(), size) -
+                   sorted.begin();
+        if (hi == 0) {
+            return sorted.front();
+        }
+        if (hi == sorted.size()) {
+            return sorted.back();
+        }
+
+        usize lo = hi - 1;
+        Int below = size - sorted[lo];
+        Int above = sorted[hi] - size;
+        if (below != above) {
+            return (below < above) ? sorted[lo] : sorted[hi];
+        }
+        return (first[lo] < first[hi]) ? sorted[lo] : sorted[hi];
+    }
+};
+
+// Read-only after `init_tables`, shared by every worker
+static AliasTable size_table;
+static AliasTable ttl_table;
+static NearestIndex size_index;
+static InverseCdf size_cdf;
+static Empirical size_empirical;
+static MarkovChain size_chain;
+static Empirical ttl_empirical;
+
+// Sorted sample of the size stream, ranks sizes for --ttl-corr
+static std::vector<Int> size_reference;
+static constexpr usize SIZE_REFERENCE = 1 << 16;
+
+void init_tables(const Args &args) {
+    size_table = AliasTable(args.size_list.as.il, args.size_weights.as.il);
+    ttl_table = AliasTable(args.ttl_list.as.il, args.ttl_weights.as.il);
+    size_index = NearestIndex(args.size_list.as.il);
+
+    size_empirical = Empirical();
+    if (args.distribution.as.e == DISTRIBUTION_EMPIRICAL) {
+        size_empirical = Empirical::load(args.dist_file.as.s);
+    }
+
+    size_chain = MarkovChain();
+    if (args.size_mode.as.e == SIZE_LIST_MODE_MARKOV) {
+        const IntList &sizes = args.size_list.as.il;
+        if (args.markov_trace.as.s != nullptr) {
+            size_chain = MarkovChain::from_trace(sizes, args.markov_trace.as.s);
+        } else if (args.markov_file.as.s != nullptr) {
+            size_chain = MarkovChain::from_file(sizes, args.markov_file.as.s);
+        } else {
+            std::vector<double> weights;
+            if (!parse_weight_line(args.markov_matrix.as.s, weights)) {
+                fatal("--markov-matrix expects non-negative weights");
+            }
+            if (weights.size() != (usize)sizes.count * sizes.count) {
+                fatal("--markov-matrix should have %u entries for %u sizes, "
+                      "but has %zu",
+                      sizes.count * sizes.count, sizes.count, weights.size());
+            }
+            size_chain = MarkovChain::from_matrix(sizes, weights);
+        }
+
+        [[maybe_unused]] double stay = size_chain.stay_probability();
+        log_info("Markov sizes: %zu states, stay probability %.3f (mean run "
+                 "%.1f)",
+                 size_chain.sizes.size(), stay,
+                 (stay < 1.0) ? 1.0 / (1.0 - stay) : INFINITY);
+    }
+
+    size_cdf = InverseCdf();
+    if (args.sampler.as.e == SAMPLER_TABLE) {
+        size_cdf = InverseCdf((Distribution)args.distribution.as.e,
+                              args.min_size.as.i, args.max_size.as.i,
+                              args.dist_param.as.f, args.cdf_size.as.i);
+    }
+    if (!size_cdf.empty()) {
+        double bound = 1.0 / (double)args.cdf_size.as.i;
+        if (size_cdf.ks > bound * (1.0 + 1e-9)) {
+            panic("Inverse-CDF table KS distance %g exceeds bound %g",
+                  size_cdf.ks, bound);
+        }
+        log_info("Inverse-CDF table: %zu intervals, KS distance %g "
+                 "(bound %g)",
+                 args.cdf_size.as.i, size_cdf.ks, bound);
+    }
+
+    ttl_empirical = Empirical();
+    if (args.ttl_mode.as.e == TTL_EMPIRICAL) {
+        ttl_empirical = Empirical::load(args.ttl_file.as.s);
+    }
+
+    size_reference.clear();
+    if (args.ttl_corr.as.f != 0.0) {
+        // own stream and trend position, workers draw the same as without
+        Random rng = Random(args.seed.as.i).split((u64)-1);
+        Int saved = exchange_trend_state(0);
+        init_actions(args);
+        for (usize i = 0; i < SIZE_REFERENCE; i++) {
+            size_reference.push_back(get_block_size(args, rng));
+        }
+        exchange_trend_state(saved);
+        std::sort(size_reference.begin(), size_reference.end());
+    }
+}
+
 void init_actions(const Args &args) {
     switch (args.size_trend.as.e) {
     case TREND_NONE:
@@ -21,96 +173,97 @@ void init_actions(const Args &args) {
     default:
         panic("Unknown trend %u", args.size_trend.as.e);
     }
-}
 
-/// @brief Block size according to trend (ignore list)
-/// @param args
-/// @return Block size
-static Int trend_block_size(const Args &args, Random &rng) {
-    SInt jitter = (SInt)rng.uniform(0, args.trend_jitter.as.i * 2) -
-                  (SInt)args.trend_jitter.as.i;
+    if (args.size_mode.as.e == SIZE_LIST_MODE_MARKOV) {
+        block_size_tmp = MARKOV_START;
+    }
+}
 
-    switch (args.size_trend.as.e) {
-    case TREND_NONE:
-        return rng.next(args.min_size.as.i, args.max_size.as.i,
-                        args.dist_param.as.f,
-                        (Distribution)args.distribution.as.e);
-    case TREND_GROW: {
-        Int tmp = block_size_tmp;
+Int exchange_trend_state(Int state) {
+    Int prev = block_size_tmp;
+    block_size_tmp = state;
+    return prev;
+}
 
-        SInt step = (SInt)args.size_step.as.i + jitter;
-        if (step <= 0) {
-            step = 1;
-        }
-        block_size_tmp += (Int)step;
-        block_size_tmp = Random::clamp(args.min_size.as.i, args.max_size.as.i,
-                                       block_size_tmp);
+/// @brief Advance the calling thread's trend `T` by one step (`jitter`
+///        already drawn) and return the size before the step
+template <Trend T>
+static inline Int trend_step(Int min, Int max, Int size_step, SInt jitter) {
+    Int tmp = block_size_tmp;
 
-        return tmp;
+    SInt step = (SInt)size_step + jitter;
+    if (step <= 0) {
+        step = 1;
     }
-    case TREND_SHRINK: {
-        Int tmp = block_size_tmp;
-        SInt step = (SInt)args.size_step.as.i + jitter;
-        if (step <= 0) {
-            step = 1;
-        }
+
+    if constexpr (T == TREND_GROW) {
+        block_size_tmp += (Int)step;
+        block_size_tmp = Random::clamp(min, max, block_size_tmp);
+    } else if constexpr (T == TREND_SHRINK) {
         if ((Int)step > block_size_tmp) {
-            block_size_tmp = args.min_size.as.i;
+            block_size_tmp = min;
         } else {
             block_size_tmp -= (Int)step;
         }
-        block_size_tmp = Random::clamp(args.min_size.as.i, args.max_size.as.i,
-                                       block_size_tmp);
-
-        return tmp;
-    }
-    case TREND_SAW: {
-        Int tmp = block_size_tmp;
-
-        SInt step = (SInt)args.size_step.as.i + jitter;
-        if (step <= 0) {
-            step = 1;
-        }
+        block_size_tmp = Random::clamp(min, max, block_size_tmp);
+    } else {
+        static_assert(T == TREND_SAW, "Unknown trend");
         block_size_tmp += (Int)step;
-        if (block_size_tmp > args.max_size.as.i) {
-            block_size_tmp = args.min_size.as.i;
+        if (block_size_tmp > max) {
+            block_size_tmp = min;
         }
-        return tmp;
-    }
-    default:
-        panic("Unknown trend %u", args.size_trend.as.e);
     }
+    return tmp;
 }
 
-static inline constexpr SInt abs_int(SInt n) { return (n >= 0) ? n : -n; }
-
-static Int get_closest(IntList *list, Int size) {
-    IntList l = *list;
-    if (l.count == 0) {
-        return size;
-    }
+/// @brief Block size according to trend (ignore list)
+/// @param args
+/// @return Block size
+static Int trend_block_size(const Args &args, Random &rng) {
+    SInt jitter = (SInt)rng.uniform(0, args.trend_jitter.as.i * 2) -
+                  (SInt)args.trend_jitter.as.i;
 
-    SInt min = -1;
-    usize idx = (usize)-1;
-    for (usize i = 0; i < l.count; i++) {
-        SInt v = abs_int((SInt)size - (SInt)l.items[i]);
-        if ((min < 0) || (v < min)) {
-            min = v;
-            idx = i;
+    Int min = args.min_size.as.i;
+    Int max = args.max_size.as.i;
+    switch (args.size_trend.as.e) {
+    case TREND_NONE:
+        if (!size_empirical.empty()) {
+            return size_empirical.sample(rng);
         }
+        if (!size_cdf.empty()) {
+            return size_cdf.sample(rng);
+        }
+        return rng.next(min, max, args.dist_param.as.f,
+                        (Distribution)args.distribution.as.e);
+    case TREND_GROW:
+        return trend_step<TREND_GROW>(min, max, args.size_step.as.i, jitter);
+    case TREND_SHRINK:
+        return trend_step<TREND_SHRINK>(min, max, args.size_step.as.i,
+                                        jitter);
+    case TREND_SAW:
+        return trend_step<TREND_SAW>(min, max, args.size_step.as.i, jitter);
+    default:
+        panic("Unknown trend %u", args.size_trend.as.e);
     }
+}
 
-    if (min < 0 || ((isize)idx) < 0) {
-        panic("Minimum and index should not be less than 0");
-    }
-
-    return l.items[idx];
+/// @brief Next state of the calling thread's (or session's) size chain
+static Int markov_block_size(Random &rng) {
+    u32 state = (block_size_tmp == MARKOV_START)
+                    ? size_chain.first(rng)
+                    : size_chain.next((u32)block_size_tmp, rng);
+    block_size_tmp = state;
+    return size_chain.sizes[state];
 }
 
 /// @brief Block size according to all argumnets
 /// @param args
 /// @return Block size
-static Int get_block_size(const Args &args, Random &rng) {
+Int get_block_size(const Args &args, Random &rng) {
+    if (!size_chain.empty()) {
+        return markov_block_size(rng);
+    }
+
     IntList l = args.size_list.as.il;
     if (l.count == 0) {
         return trend_block_size(args, rng);
@@ -118,48 +271,237 @@ static Int get_block_size(const Args &args, Random &rng) {
 
     switch (args.size_mode.as.e) {
     case SIZE_LIST_MODE_EXACT:
-        return rng.choice(l, args.size_weights.as.il);
+        return size_table.sample(rng);
     case SIZE_LIST_MODE_NEAREST: {
-        return get_closest(&l, trend_block_size(args, rng));
+        return size_index.closest(trend_block_size(args, rng));
     } break;
     default:
         panic("Unknown size mode %u", args.size_mode.as.e);
     }
 }
 
-static SInt get_block_ttl(const Args &args, Random &rng) {
+/// @brief Quantile of `size` in the reference sample, ties are spread
+///        uniformly so the result stays uniform on [0, 1]
+static double size_rank(Int size, Random &rng) {
+    auto lo = std::lower_bound(size_reference.begin(), size_reference.end(),
+                               size);
+    auto hi = std::upper_bound(lo, size_reference.end(), size);
+    double below = (double)(lo - size_reference.begin());
+    return (below + rng.uniform01() * (double)(hi - lo)) /
+           (double)size_reference.size();
+}
+
+/// @brief Quantile of the next lifetime. With probability |--ttl-corr| it
+///        is the size's own rank (or its mirror), otherwise independent.
+///        This mixes the comonotone and independent copulas, whose
+///        Spearman correlation is exactly --ttl-corr
+static double ttl_quantile(const Args &args, Random &rng, Int size) {
+    Float corr = args.ttl_corr.as.f;
+    if (corr != 0.0 && rng.uniform01() < std::fabs(corr)) {
+        double u = size_rank(size, rng);
+        return (corr > 0.0) ? u : 1.0 - u;
+    }
+    return rng.uniform01();
+}
+
+SInt get_block_ttl(const Args &args, Random &rng, Int size) {
     switch (args.ttl_mode.as.e) {
     case TTL_OFF:
         return -1L;
     case TTL_FIXED:
         return (SInt)args.ttl_fixed.as.i;
     case TTL_LIST:
-        return (SInt)rng.choice(args.ttl_list.as.il, args.ttl_weights.as.il);
+        return (SInt)ttl_table.sample(rng);
+    case TTL_EXP:
+        return (SInt)Random::exponential_at(ttl_quantile(args, rng, size),
+                                            args.ttl_min.as.i,
+                                            args.ttl_max.as.i,
+                                            args.ttl_param.as.f);
+    case TTL_POWERLAW:
+        return (SInt)Random::powerlaw_at(ttl_quantile(args, rng, size),
+                                         args.ttl_min.as.i, args.ttl_max.as.i,
+                                         args.ttl_param.as.f);
+    case TTL_EMPIRICAL:
+        return (SInt)ttl_empirical.at(ttl_quantile(args, rng, size));
     default:
         panic("Unknown ttl mode %d", args.ttl_mode.as.e);
     }
 }
 
-static inline constexpr bool should_alloc(const Pool &pool, const Args &args,
-                                          Random &rng) {
+static inline bool should_alloc(const Pool &pool, const Args &args,
+                                Random &rng) {
     return (pool.count() < pool.capacity) &&
            (rng.uniform01() < args.alloc_freq.as.f);
 }
 
+/// @brief Draw only when resizing is enabled, so runs without it keep the
+///        same random sequence
+static inline bool should_resize(const Pool &pool, const Args &args,
+                                 Random &rng) {
+    return (args.resize_freq.as.f > 0.0) && (pool.count() > 0) &&
+           (rng.uniform01() < args.resize_freq.as.f);
+}
+
 void block_action(Pool &pool, const Args &args, Random &rng) {
     if (args.ttl_mode.as.e != TTL_OFF) {
         pool.update_and_prune();
     }
 
+    if (should_resize(pool, args, rng)) {
+        usize idx = rng.uniform(0, pool.count());
+        pool.resize_block(idx, get_block_size(args, rng));
+        return;
+    }
+
     bool alloc = should_alloc(pool, args, rng);
 
     if (!alloc) {
         pool.del_block((Policy)args.policy.as.e, rng);
     } else {
         Int block_size = get_block_size(args, rng);
-        SInt block_ttl = get_block_ttl(args, rng);
+        SInt block_ttl = get_block_ttl(args, rng, block_size);
         pool.add_block(block_size, block_ttl);
     }
 }
 
+Params::Params(const Args &args)
+    : capacity(args.capacity.as.i), alloc_freq(args.alloc_freq.as.f),
+      resize_freq(args.resize_freq.as.f), min_size(args.min_size.as.i),
+      max_size(args.max_size.as.i), dist_param(args.dist_param.as.f),
+      size_step(args.size_step.as.i), trend_jitter(args.trend_jitter.as.i),
+      ttl_fixed(args.ttl_fixed.as.i), ttl_min(args.ttl_min.as.i),
+      ttl_max(args.ttl_max.as.i), ttl_param(args.ttl_param.as.f),
+      snap_interval((args.snap_interval.as.i > 0) ? args.snap_interval.as.i
+                                                  : 1) {}
+
+/// @brief `trend_block_size` for trend `T` and distribution `D`
+template <Trend T, Distribution D>
+static inline Int next_size(const Params &p, Random &rng) {
+    SInt jitter = (SInt)rng.uniform(0, p.trend_jitter * 2) -
+                  (SInt)p.trend_jitter;
+
+    if constexpr (T != TREND_NONE) {
+        return trend_step<T>(p.min_size, p.max_size, p.size_step, jitter);
+    } else if constexpr (D == DISTRIBUTION_UNIFORM) {
+        return rng.uniform(p.min_size, p.max_size);
+    } else if constexpr (D == DISTRIBUTION_EXP) {
+        return rng.exponential(p.min_size, p.max_size, p.dist_param);
+    } else {
+        static_assert(D == DISTRIBUTION_POWERLAW, "Unsupported distribution");
+        return rng.powerlaw(p.min_size, p.max_size, p.dist_param);
+    }
+}
+
+/// @brief `get_block_ttl` for ttl mode `L`, uncorrelated
+template <Lifetime L>
+static inline SInt next_ttl(const Params &p, Random &rng) {
+    if constexpr (L == TTL_OFF) {
+        return -1L;
+    } else if constexpr (L == TTL_FIXED) {
+        return (SInt)p.ttl_fixed;
+    } else if constexpr (L == TTL_EXP) {
+        return (SInt)rng.exponential(p.ttl_min, p.ttl_max, p.ttl_param);
+    } else {
+        static_assert(L == TTL_POWERLAW, "Unsupported ttl mode");
+        return (SInt)rng.powerlaw(p.ttl_min, p.ttl_max, p.ttl_param);
+    }
+}
+
+/// @brief The single threaded main loop around `block_action`, with every
+///        per-iteration switch resolved at compile time. Same draws in the
+///        same order as the generic loop
+template <Policy P, Trend T, Lifetime L, Distribution D>
+static void run_loop(Pool &pool, const Params &p, Random &rng,
+                     utils::ProgressBar &progress, std::ofstream &output) {
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+
+    while (progress.has_next()) {
+        usize i = progress.next();
+
+        if constexpr (L != TTL_OFF) {
+            pool.update_and_prune();
+        }
+
+        if ((p.resize_freq > 0.0) && (pool.count() > 0) &&
+            (rng.uniform01() < p.resize_freq)) {
+            usize idx = rng.uniform(0, pool.count());
+            pool.resize_block(idx, next_size<T, D>(p, rng));
+        } else if ((pool.count() < p.capacity) &&
+                   (rng.uniform01() < p.alloc_freq)) {
+            Int size = next_size<T, D>(p, rng);
+            pool.add_block(size, next_ttl<L>(p, rng));
+        } else {
+            pool.del_block<P>(rng);
+        }
+
+        backend::maintain(i);
+        reclaim::tick(i);
+
+        if (output.is_open() && ((i % p.snap_interval) == 0)) {
+            tracker.write(output);
+        }
+    }
+}
+
+// Dispatch table over policy x trend x ttl mode x distribution. Trends
+// other than none ignore the distribution and only have a uniform entry,
+// modes that need shared tables (list, empirical) have none
+static constexpr usize POLICIES = POLICY_COUNT;
+static constexpr usize TRENDS = TREND_COUNT;
+static constexpr usize TTLS = TTL_COUNT;
+static constexpr usize DISTRIBUTIONS = DISTRIBUTION_COUNT;
+static constexpr usize LOOP_COUNT = POLICIES * TRENDS * TTLS * DISTRIBUTIONS;
+
+static constexpr usize loop_index(u32 policy, u32 trend, u32 ttl, u32 dist) {
+    return ((policy * TRENDS + trend) * TTLS + ttl) * DISTRIBUTIONS + dist;
+}
+
+template <usize I> static constexpr Loop loop_entry() {
+    constexpr auto P = (Policy)(I / (TRENDS * TTLS * DISTRIBUTIONS));
+    constexpr auto T = (Trend)(I / (TTLS * DISTRIBUTIONS) % TRENDS);
+    constexpr auto L = (Lifetime)(I / DISTRIBUTIONS % TTLS);
+    constexpr auto D = (Distribution)(I % DISTRIBUTIONS);
+
+    constexpr bool ttl_ok = (L == TTL_OFF) || (L == TTL_FIXED) ||
+                            (L == TTL_EXP) || (L == TTL_POWERLAW);
+    constexpr bool dist_ok =
+        (T == TREND_NONE) ? (D != DISTRIBUTION_EMPIRICAL)
+                          : (D == DISTRIBUTION_UNIFORM);
+    if constexpr (ttl_ok && dist_ok) {
+        return &run_loop<P, T, L, D>;
+    } else {
+        return nullptr;
+    }
+}
+
+template <usize... I>
+static constexpr std::array<Loop, LOOP_COUNT>
+make_loops(std::index_sequence<I...>) {
+    return {loop_entry<I>()...};
+}
+
+static constexpr auto loops =
+    make_loops(std::make_index_sequence<LOOP_COUNT>{});
+
+Loop specialised_loop(const Args &args) {
+    // everything drawn from a table built by `init_tables`, or a mode the
+    // loop doesn't replicate, stays on `block_action`
+    if (args.generic_loop.as.b || (args.size_list.as.il.count > 0) ||
+        !size_chain.empty() || !size_empirical.empty() || !size_cdf.empty() ||
+        (args.ttl_corr.as.f != 0.0) || (args.sites.as.s != nullptr) ||
+        (args.schedule.as.e != SCHEDULE_OFF)) {
+        return nullptr;
+    }
+
+    u32 trend = args.size_trend.as.e;
+    u32 dist = (trend == TREND_NONE) ? args.distribution.as.e
+                                     : (u32)DISTRIBUTION_UNIFORM;
+    if (args.policy.as.e >= POLICY_COUNT || trend >= TREND_COUNT ||
+        args.ttl_mode.as.e >= TTL_COUNT || dist >= DISTRIBUTION_COUNT) {
+        return nullptr;
+    }
+    return loops[loop_index(args.policy.as.e, trend, args.ttl_mode.as.e,
+                            dist)];
+}
+
 } // namespace action
\ No newline at end of file
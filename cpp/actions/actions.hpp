@@ -6,12 +6,56 @@
 
 #include "../pool/pool.hpp"
 #include "../random/random.hpp"
+#include "../utils/progress.hpp"
+
+#include <fstream>
 
 namespace action {
 
 void block_action(Pool &pool, const Args &args, Random &rng);
 void init_actions(const Args &args);
 
+/// @brief Compile size/TTL lists into alias tables and the nearest size
+///        index. Call once before any worker starts
+void init_tables(const Args &args);
+
+/// @brief Swap trend position of the calling thread, so several streams
+///        (sessions) multiplexed on one thread can each follow their own
+///        trend. Returns the previous position
+Int exchange_trend_state(Int state);
+
+Int get_block_size(const Args &args, Random &rng);
+/// @brief Lifetime of a new block of `size` bytes (size matters only
+///        with --ttl-corr)
+SInt get_block_ttl(const Args &args, Random &rng, Int size);
+
+/// Arguments the main loop reads every iteration, copied out of `Args`
+/// once instead of going through its tagged unions
+struct Params {
+    Int capacity;
+    Float alloc_freq;
+    Float resize_freq;
+    Int min_size, max_size;
+    Float dist_param;
+    Int size_step, trend_jitter;
+    Int ttl_fixed, ttl_min, ttl_max;
+    Float ttl_param;
+    Int snap_interval;
+
+    explicit Params(const Args &args);
+};
+
+/// Single threaded main loop, snapshots into `output` when it is open
+using Loop = void (*)(Pool &pool, const Params &params, Random &rng,
+                      utils::ProgressBar &progress, std::ofstream &output);
+
+/// @brief Main loop compiled for the policy, trend, ttl mode and
+///        distribution of `args`, picked once from a constexpr table.
+///        nullptr when `args` needs the generic `block_action` (size
+///        lists, Markov, empirical or table sizes, list or empirical
+///        lifetimes, --ttl-corr, --sites, --schedule, --generic-loop)
+Loop specialised_loop(const Args &args);
+
 } // namespace action
 
 #endif // ACTIONS_HPP
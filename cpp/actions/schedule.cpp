@@ -0,0 +1,261 @@
+#include "schedule.hpp"
+
+#include "actions.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace schedule {
+
+/// Sizes and lifetimes of the blocks the replayed pool will hold, so the
+/// generator picks victims exactly like `Pool` without allocating
+struct ShadowBlock {
+    Int size;
+    SInt ttl;
+};
+
+/// Makes the ops of `action::block_action` against a shadow pool, with
+/// the same draws in the same order
+class Generator {
+  public:
+    Generator(const Args &args, const Random &rng) : args(args), rng(rng) {}
+
+    void fill(Op *ops, usize count) {
+        for (usize i = 0; i < count; i++) {
+            ops[i] = next();
+        }
+    }
+
+  private:
+    const Args &args;
+    Random rng;
+    std::deque<ShadowBlock> blocks;
+
+    /// @brief Same as `Pool::update_and_prune`
+    void prune() {
+        auto dead = std::remove_if(blocks.begin(), blocks.end(),
+                                   [](ShadowBlock &b) {
+                                       if (b.ttl > 0) {
+                                           b.ttl--;
+                                       }
+                                       return b.ttl == 0;
+                                   });
+        blocks.erase(dead, blocks.end());
+    }
+
+    /// @brief Same as `Pool::del_block`, returns the victim's position
+    Op evict(Policy policy) {
+        if (policy == POLICY_NEVER || blocks.empty()) {
+            return {0, 0, 0, OP_NONE};
+        }
+
+        auto by_size = [](const ShadowBlock &lhs, const ShadowBlock &rhs) {
+            return lhs.size < rhs.size;
+        };
+
+        usize idx;
+        switch (policy) {
+        case POLICY_LIFO:
+            idx = blocks.size() - 1;
+            break;
+        case POLICY_FIFO:
+            idx = 0;
+            break;
+        case POLICY_RANDOM:
+            idx = rng.uniform(0, blocks.size());
+            break;
+        case POLICY_BIG_FIRST:
+            idx = std::max_element(blocks.begin(), blocks.end(), by_size) -
+                  blocks.begin();
+            break;
+        case POLICY_SMALL_FIRST:
+            idx = std::min_element(blocks.begin(), blocks.end(), by_size) -
+                  blocks.begin();
+            break;
+        default:
+            panic("Unknown policy");
+        }
+
+        blocks.erase(blocks.begin() + idx);
+        return {0, 0, (u32)idx, OP_FREE};
+    }
+
+    Op next() {
+        if (args.ttl_mode.as.e != TTL_OFF) {
+            prune();
+        }
+
+        if ((args.resize_freq.as.f > 0.0) && !blocks.empty() &&
+            (rng.uniform01() < args.resize_freq.as.f)) {
+            usize idx = rng.uniform(0, blocks.size());
+            Int size = action::get_block_size(args, rng);
+            blocks[idx].size = size;
+            return {size, 0, (u32)idx, OP_RESIZE};
+        }
+
+        if ((blocks.size() < args.capacity.as.i) &&
+            (rng.uniform01() < args.alloc_freq.as.f)) {
+            Int size = action::get_block_size(args, rng);
+            SInt ttl = action::get_block_ttl(args, rng, size);
+            blocks.push_back({size, ttl});
+            return {size, ttl, 0, OP_ALLOC};
+        }
+
+        return evict((Policy)args.policy.as.e);
+    }
+};
+
+static Schedule mode = SCHEDULE_OFF;
+
+// 'full' keeps everything in buffers[0]. 'chunked' hands the two buffers
+// back and forth with the generator thread, `ready` is owned by whoever
+// holds `mutex`
+static std::vector<Op> buffers[2];
+static bool ready[2];
+static usize current = 0; // buffer being replayed
+static usize cursor = 0;  // next op in it
+
+static std::mutex mutex;
+static std::condition_variable cv;
+static std::thread generator;
+static bool stop = false;
+
+static usize chunks = 0;
+static u64 wait_ns = 0;
+
+static void generate(const Args &args, Random rng) {
+    // trend and Markov state are per thread
+    action::init_actions(args);
+    Generator gen = Generator(args, rng);
+
+    for (usize b = 0;; b ^= 1) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [b]() { return stop || !ready[b]; });
+            if (stop) {
+                return;
+            }
+        }
+
+        gen.fill(buffers[b].data(), buffers[b].size());
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready[b] = true;
+            chunks++;
+        }
+        cv.notify_all();
+    }
+}
+
+void init(const Args &args, const Random &rng) {
+    mode = (Schedule)args.schedule.as.e;
+    if (mode == SCHEDULE_OFF) {
+        return;
+    }
+    if (args.capacity.as.i > UINT32_MAX) {
+        fatal("--schedule stores pool positions in 32 bits, --capacity %zu "
+              "is too large",
+              args.capacity.as.i);
+    }
+
+    if (mode == SCHEDULE_FULL) {
+        buffers[0].resize(args.iterations.as.i);
+        Generator(args, rng).fill(buffers[0].data(), buffers[0].size());
+        chunks = 1;
+        log_info("Schedule: %zu ops generated (%zu B)", buffers[0].size(),
+                 buffers[0].size() * sizeof(Op));
+        return;
+    }
+
+    for (usize b = 0; b < 2; b++) {
+        buffers[b].resize(args.schedule_chunk.as.i);
+        ready[b] = false;
+    }
+    stop = false;
+    generator = std::thread(generate, std::cref(args), rng);
+
+    // start on an exhausted buffer 1, the first replay waits for buffer 0
+    current = 1;
+    cursor = buffers[1].size();
+}
+
+bool enabled() { return mode != SCHEDULE_OFF; }
+
+/// @brief Give the replayed buffer back and wait for the other one
+static void next_chunk() {
+    if (mode == SCHEDULE_FULL) {
+        panic("Schedule ran out after %zu ops", buffers[0].size());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready[current] = false;
+    }
+    cv.notify_all();
+
+    current ^= 1;
+    cursor = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, []() { return ready[current]; });
+    wait_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - begin)
+                   .count();
+}
+
+void replay(Pool &pool, const Args &args) {
+    if (cursor == buffers[current].size()) {
+        next_chunk();
+    }
+
+    if (args.ttl_mode.as.e != TTL_OFF) {
+        pool.update_and_prune();
+    }
+
+    const Op &op = buffers[current][cursor++];
+    switch (op.kind) {
+    case OP_NONE:
+        break;
+    case OP_ALLOC:
+        pool.add_block(op.size, op.ttl);
+        break;
+    case OP_FREE:
+        pool.del_block_at(op.index);
+        break;
+    case OP_RESIZE:
+        pool.resize_block(op.index, op.size);
+        break;
+    }
+}
+
+void shutdown() {
+    if (mode != SCHEDULE_CHUNKED || !generator.joinable()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv.notify_all();
+    generator.join();
+}
+
+void print_report() {
+    usize ops = buffers[0].size();
+    std::cout << std::fixed << std::setprecision(1) << "schedule "
+              << schedules[mode] << ": " << chunks << " chunks of " << ops
+              << " ops (" << ops * sizeof(Op) << " B each), replay waited "
+              << wait_ns / 1e6 << " ms for the generator\n";
+}
+
+} // namespace schedule
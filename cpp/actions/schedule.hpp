@@ -0,0 +1,44 @@
+#ifndef SCHEDULE_HPP
+#define SCHEDULE_HPP
+
+#include "../../c/utils/args_parser.h"
+#include "../../c/utils/common.h"
+
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+
+namespace schedule {
+
+enum OpKind : u8 { OP_NONE, OP_ALLOC, OP_FREE, OP_RESIZE };
+
+/// One pre-generated step of the main loop. Victims and resize targets
+/// are already resolved to a position in the pool
+struct Op {
+    Int size;  // OP_ALLOC, OP_RESIZE
+    SInt ttl;  // OP_ALLOC
+    u32 index; // OP_FREE, OP_RESIZE
+    OpKind kind;
+};
+
+/// @brief Set up --schedule, no-op when off. `rng` is the stream the
+///        main loop would have drawn from, so the replayed ops are the
+///        ones `action::block_action` makes. 'full' generates every op
+///        here, 'chunked' starts a generator thread that fills one buffer
+///        while the other is replayed
+void init(const Args &args, const Random &rng);
+
+bool enabled();
+
+/// @brief Apply the next op to `pool`, touching nothing but the pool and
+///        the allocator
+void replay(Pool &pool, const Args &args);
+
+/// @brief Stop the generator thread
+void shutdown();
+
+/// @brief Chunks generated and time the replay waited for them
+void print_report();
+
+} // namespace schedule
+
+#endif // SCHEDULE_HPP
@@ -0,0 +1,242 @@
+#include "sites.hpp"
+
+#include "../random/alias.hpp"
+#include "../tracker/tracker.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace sites {
+
+static std::vector<Site> sites;
+static std::deque<Pool> pools; // one per site, Pool can't be moved
+static AliasTable site_table;   // values are site positions
+
+/// @brief Position of `value` in `names`, `count` when it isn't there
+static u32 find_name(const char *const *names, u32 count,
+                     const std::string &value) {
+    for (u32 i = 0; i < count; i++) {
+        if (names[i] != nullptr && value == names[i]) {
+            return i;
+        }
+    }
+    return count;
+}
+
+static Site parse_site(const Args &args, const std::string &line,
+                       const char *path, usize lineno) {
+    Site s = {
+        .name = "site" + std::to_string(sites.size()),
+        .weight = 1.0,
+        .distribution = (Distribution)args.distribution.as.e,
+        .min_size = args.min_size.as.i,
+        .max_size = args.max_size.as.i,
+        .dist_param = args.dist_param.as.f,
+        .ttl_mode = (Lifetime)args.ttl_mode.as.e,
+        .ttl_fixed = args.ttl_fixed.as.i,
+        .ttl_min = args.ttl_min.as.i,
+        .ttl_max = args.ttl_max.as.i,
+        .ttl_param = args.ttl_param.as.f,
+        .policy = (Policy)args.policy.as.e,
+    };
+
+    std::istringstream fields(line);
+    std::string field;
+    while (fields >> field) {
+        usize eq = field.find('=');
+        if (eq == std::string::npos || eq == 0 || eq + 1 == field.size()) {
+            fatal("%s:%zu: expected `key=value`, got `%s`", path, lineno,
+                  field.c_str());
+        }
+        std::string key = field.substr(0, eq);
+        std::string value = field.substr(eq + 1);
+        const char *v = value.c_str();
+
+        if (key == "name") {
+            s.name = value;
+        } else if (key == "weight") {
+            s.weight = parse_float(v);
+        } else if (key == "dist") {
+            s.distribution = (Distribution)find_name(
+                distributions, DISTRIBUTION_COUNT, value);
+        } else if (key == "min") {
+            s.min_size = parse_size(v);
+        } else if (key == "max") {
+            s.max_size = parse_size(v);
+        } else if (key == "param") {
+            s.dist_param = parse_float(v);
+        } else if (key == "ttl") {
+            s.ttl_mode = (Lifetime)find_name(ttls, TTL_COUNT, value);
+        } else if (key == "ttl-fixed") {
+            s.ttl_fixed = parse_int(v);
+        } else if (key == "ttl-min") {
+            s.ttl_min = parse_int(v);
+        } else if (key == "ttl-max") {
+            s.ttl_max = parse_int(v);
+        } else if (key == "ttl-param") {
+            s.ttl_param = parse_float(v);
+        } else if (key == "policy") {
+            s.policy = (Policy)find_name(policies, POLICY_COUNT, value);
+        } else {
+            fatal("%s:%zu: unknown key `%s`", path, lineno, key.c_str());
+        }
+    }
+
+    // tables behind the list and empirical modes are global, not per site
+    const char *name = s.name.c_str();
+    if (s.distribution >= DISTRIBUTION_EMPIRICAL) {
+        fatal("%s:%zu: site %s needs dist uniform, exp or powerlaw", path,
+              lineno, name);
+    }
+    if (s.ttl_mode == TTL_LIST || s.ttl_mode >= TTL_EMPIRICAL) {
+        fatal("%s:%zu: site %s needs ttl off, fixed, exp or powerlaw", path,
+              lineno, name);
+    }
+    if (s.policy >= POLICY_COUNT) {
+        fatal("%s:%zu: site %s has an unknown policy", path, lineno, name);
+    }
+    if (s.weight < 0.0) {
+        fatal("%s:%zu: site %s has a negative weight", path, lineno, name);
+    }
+    if (s.min_size == 0 || s.min_size > s.max_size) {
+        fatal("%s:%zu: site %s needs 0 < min <= max", path, lineno, name);
+    }
+    if ((s.ttl_mode == TTL_FIXED && s.ttl_fixed == 0) ||
+        (s.ttl_min == 0 || s.ttl_min > s.ttl_max)) {
+        fatal("%s:%zu: site %s needs a positive ttl-fixed and "
+              "0 < ttl-min <= ttl-max",
+              path, lineno, name);
+    }
+    if (s.policy == POLICY_NEVER && s.ttl_mode == TTL_OFF) {
+        fatal("%s:%zu: site %s never frees its blocks", path, lineno, name);
+    }
+    return s;
+}
+
+void init(const Args &args) {
+    if (args.sites.as.s == nullptr) {
+        return;
+    }
+
+    const char *path = args.sites.as.s;
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fatal("Could not open sites %s: %s", path, strerror(errno));
+    }
+
+    std::string line;
+    usize lineno = 0;
+    while (std::getline(file, line)) {
+        lineno++;
+        usize hash = line.find('#');
+        if (hash != std::string::npos) {
+            line.resize(hash);
+        }
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        sites.push_back(parse_site(args, line, path, lineno));
+    }
+    if (sites.empty()) {
+        fatal("%s: no sites", path);
+    }
+
+    std::vector<Int> positions;
+    std::vector<double> weights;
+    for (usize k = 0; k < sites.size(); k++) {
+        positions.push_back(k);
+        weights.push_back(sites[k].weight);
+        pools.emplace_back(args.capacity.as.i);
+    }
+    site_table = AliasTable(std::move(positions), weights);
+
+    tracker::Tracker::instance().setSites(sites.size());
+    log_info("Loaded %zu allocation sites from %s", sites.size(), path);
+}
+
+bool enabled() { return !sites.empty(); }
+
+static Int site_size(const Site &s, Random &rng) {
+    return rng.next(s.min_size, s.max_size, s.dist_param, s.distribution);
+}
+
+static SInt site_ttl(const Site &s, Random &rng) {
+    switch (s.ttl_mode) {
+    case TTL_OFF:
+        return -1L;
+    case TTL_FIXED:
+        return (SInt)s.ttl_fixed;
+    case TTL_EXP:
+        return (SInt)rng.exponential(s.ttl_min, s.ttl_max, s.ttl_param);
+    case TTL_POWERLAW:
+        return (SInt)rng.powerlaw(s.ttl_min, s.ttl_max, s.ttl_param);
+    default:
+        panic("Unknown site ttl mode %d", s.ttl_mode);
+    }
+}
+
+void block_action(const Args &args, Random &rng) {
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+
+    usize live = 0;
+    for (usize k = 0; k < sites.size(); k++) {
+        if (sites[k].ttl_mode != TTL_OFF) {
+            tracker.setSite(k);
+            pools[k].update_and_prune();
+        }
+        live += pools[k].count();
+    }
+
+    u32 k = site_table.sample_index(rng);
+    const Site &s = sites[k];
+    Pool &pool = pools[k];
+    tracker.setSite(k);
+
+    // same draws as `action::block_action`, on the site's pool
+    if ((args.resize_freq.as.f > 0.0) && (pool.count() > 0) &&
+        (rng.uniform01() < args.resize_freq.as.f)) {
+        usize idx = rng.uniform(0, pool.count());
+        pool.resize_block(idx, site_size(s, rng));
+    } else if ((live < args.capacity.as.i) &&
+               (rng.uniform01() < args.alloc_freq.as.f)) {
+        Int size = site_size(s, rng);
+        pool.add_block(size, site_ttl(s, rng));
+    } else {
+        pool.del_block(s.policy, rng);
+    }
+
+    tracker.setSite(tracker::Tracker::NO_SITE);
+}
+
+void print_report() {
+    const tracker::Tracker &tracker = tracker::Tracker::instance();
+
+    std::cout << "sites: " << sites.size() << "\n";
+    for (usize k = 0; k < sites.size(); k++) {
+        const tracker::SiteStats &st = tracker.siteStats(k);
+        std::cout << "  " << std::left << std::setw(16) << sites[k].name
+                  << std::right << " " << st.allocations.get() << " allocs, "
+                  << st.frees.get() << " frees, " << st.resizes.get()
+                  << " resizes, " << st.current_count.get() << " live ("
+                  << st.current_size.get() << " B), peak "
+                  << st.peak_size.get() << " B\n";
+    }
+}
+
+void shutdown() {
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+    for (usize k = 0; k < pools.size(); k++) {
+        tracker.setSite(k);
+        pools[k].blocks.clear();
+    }
+    tracker.setSite(tracker::Tracker::NO_SITE);
+    pools.clear();
+}
+
+} // namespace sites
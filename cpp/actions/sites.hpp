@@ -0,0 +1,56 @@
+#ifndef SITES_HPP
+#define SITES_HPP
+
+#include "../../c/utils/args_parser.h"
+#include "../../c/utils/common.h"
+
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+
+#include <string>
+
+namespace sites {
+
+/// One synthetic allocation site with its own rate, size and lifetime
+/// signature. Keys a site line leaves out come from the command line
+struct Site {
+    std::string name;
+    double weight;
+
+    Distribution distribution;
+    Int min_size, max_size;
+    Float dist_param;
+
+    Lifetime ttl_mode; // off, fixed, exp or powerlaw
+    Int ttl_fixed, ttl_min, ttl_max;
+    Float ttl_param;
+
+    Policy policy;
+};
+
+/// @brief Load --sites, no-op without it. A site is one line of
+///        `key=value` fields, `#` starts a comment:
+///
+///            name=strings weight=40 dist=exp min=16 max=256 param=0.05
+///                         ttl=exp ttl-min=1 ttl-max=5000 policy=fifo
+///
+///        keys are name, weight, dist, min, max, param, ttl, ttl-fixed,
+///        ttl-min, ttl-max, ttl-param and policy
+void init(const Args &args);
+
+bool enabled();
+
+/// @brief One step of the main loop with sites. A site is drawn by
+///        weight, then allocates into or frees from its own pool with its
+///        own policy. --capacity bounds the blocks of all sites together
+void block_action(const Args &args, Random &rng);
+
+/// @brief Live bytes and operations of every site
+void print_report();
+
+/// @brief Destroy the blocks still held by the sites
+void shutdown();
+
+} // namespace sites
+
+#endif // SITES_HPP
@@ -0,0 +1,344 @@
+#include "backend.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+#include <sys/mman.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#endif
+
+namespace backend {
+
+static constexpr usize DEFAULT_HUGE_PAGE = 2UL << 20;
+
+static HugePages mode = HUGE_PAGES_OFF;
+static usize threshold = (usize)-1;
+static usize page_size = DEFAULT_HUGE_PAGE;
+// Same fields as `Stats`, updated from any worker thread
+struct AtomicStats {
+    std::atomic<usize> live_mappings{0};
+    std::atomic<usize> hugetlb_mappings{0};
+    std::atomic<usize> thp_mappings{0};
+    std::atomic<usize> hugetlb_fallbacks{0};
+    std::atomic<usize> resizes_in_place{0};
+    std::atomic<usize> resizes_remapped{0};
+    std::atomic<usize> resizes_copied{0};
+    std::atomic<usize> resize_time_ns{0};
+    std::atomic<usize> release_calls{0};
+    std::atomic<usize> released_bytes{0};
+    std::atomic<usize> trim_calls{0};
+    std::atomic<usize> trim_time_ns{0};
+
+    void reset() {
+        live_mappings = 0;
+        hugetlb_mappings = 0;
+        thp_mappings = 0;
+        hugetlb_fallbacks = 0;
+        resizes_in_place = 0;
+        resizes_remapped = 0;
+        resizes_copied = 0;
+        resize_time_ns = 0;
+        release_calls = 0;
+        released_bytes = 0;
+        trim_calls = 0;
+        trim_time_ns = 0;
+    }
+
+    Stats load() const {
+        Stats s;
+        s.live_mappings = live_mappings;
+        s.hugetlb_mappings = hugetlb_mappings;
+        s.thp_mappings = thp_mappings;
+        s.hugetlb_fallbacks = hugetlb_fallbacks;
+        s.resizes_in_place = resizes_in_place;
+        s.resizes_remapped = resizes_remapped;
+        s.resizes_copied = resizes_copied;
+        s.resize_time_ns = resize_time_ns;
+        s.release_calls = release_calls;
+        s.released_bytes = released_bytes;
+        s.trim_calls = trim_calls;
+        s.trim_time_ns = trim_time_ns;
+        return s;
+    }
+};
+
+static AtomicStats counters;
+
+static Release release = RELEASE_OFF;
+static usize madvise_min = (usize)-1;
+static usize trim_interval = 0;
+static usize trim_threshold = 0;
+static std::atomic<usize> freed_since_trim = 0;
+
+/// @brief Read default huge page size from /proc/meminfo
+static usize read_huge_page_size() {
+    std::ifstream meminfo("/proc/meminfo");
+    if (!meminfo.is_open()) {
+        return DEFAULT_HUGE_PAGE;
+    }
+
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        std::istringstream iss(line);
+        std::string key;
+        usize value;
+
+        if ((iss >> key >> value) && key == "Hugepagesize:") {
+            return (value > 0) ? value * 1024 : DEFAULT_HUGE_PAGE;
+        }
+    }
+
+    return DEFAULT_HUGE_PAGE;
+}
+
+static inline usize align_up(usize n, usize align) {
+    return (n + align - 1) & ~(align - 1);
+}
+
+void init(const Args &args) {
+    mode = (HugePages)args.huge_pages.as.e;
+    threshold = (mode == HUGE_PAGES_OFF) ? (usize)-1 : args.huge_threshold.as.i;
+    page_size = read_huge_page_size();
+    counters.reset();
+
+    release = (Release)args.release.as.e;
+    madvise_min = args.madvise_min.as.i;
+    trim_interval = (release == RELEASE_TRIM) ? args.trim_interval.as.i : 0;
+    trim_threshold = (release == RELEASE_TRIM) ? args.trim_threshold.as.i : 0;
+    freed_since_trim = 0;
+
+#if !defined(__GLIBC__)
+    if (release == RELEASE_TRIM) {
+        log_warn("malloc_trim is only available with glibc");
+        trim_interval = 0;
+        trim_threshold = 0;
+    }
+#endif
+
+#if !defined(MADV_HUGEPAGE)
+    if (mode != HUGE_PAGES_OFF) {
+        log_warn("Huge pages are not supported on this platform");
+        mode = HUGE_PAGES_OFF;
+        threshold = (usize)-1;
+    }
+#endif
+}
+
+bool is_mapped(usize size) { return size >= threshold; }
+
+usize huge_page_size() { return page_size; }
+
+Stats stats() { return counters.load(); }
+
+/// @brief Map `len` bytes (multiple of huge page size) aligned to huge page
+///        boundary, so THP can back the whole region
+static void *map_aligned(usize len) {
+    usize raw_len = len + page_size;
+    void *raw = mmap(nullptr, raw_len, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+
+    uintptr_t start = (uintptr_t)raw;
+    uintptr_t aligned = align_up(start, page_size);
+    usize head = aligned - start;
+    usize tail = raw_len - head - len;
+
+    if (head > 0) {
+        munmap(raw, head);
+    }
+    if (tail > 0) {
+        munmap((void *)(aligned + len), tail);
+    }
+
+    return (void *)aligned;
+}
+
+static void *map_large(usize size) {
+    usize len = align_up(size, page_size);
+
+#if defined(MAP_HUGETLB)
+    if (mode == HUGE_PAGES_HUGETLB) {
+        void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            counters.hugetlb_mappings++;
+            counters.live_mappings++;
+            return p;
+        }
+        // hugetlbfs pool empty or not configured
+        counters.hugetlb_fallbacks++;
+    }
+#endif
+
+    void *p = map_aligned(len);
+#if defined(MADV_HUGEPAGE)
+    if (madvise(p, len, MADV_HUGEPAGE) == 0) {
+        counters.thp_mappings++;
+    }
+#endif
+    counters.live_mappings++;
+
+    return p;
+}
+
+static void trim() {
+#if defined(__GLIBC__)
+    auto start = std::chrono::steady_clock::now();
+    malloc_trim(0);
+    counters.trim_time_ns +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+    counters.trim_calls++;
+#endif
+    freed_since_trim = 0;
+}
+
+/// @brief Drop whole pages inside a heap block that is about to be freed.
+///        Chunk headers live outside the page aligned interior, so the
+///        allocator keeps working on the block after this
+static void release_pages(void *p, usize size) {
+    usize page = (usize)sysconf(_SC_PAGESIZE);
+    uintptr_t start = align_up((uintptr_t)p, page);
+    uintptr_t end = ((uintptr_t)p + size) & ~(page - 1);
+    if (end <= start) {
+        return;
+    }
+
+#if defined(MADV_FREE)
+    int advice = (release == RELEASE_FREE) ? MADV_FREE : MADV_DONTNEED;
+#else
+    int advice = MADV_DONTNEED;
+#endif
+    if (madvise((void *)start, end - start, advice) == 0) {
+        counters.release_calls++;
+        counters.released_bytes += end - start;
+    }
+}
+
+usize usable_size(void *p, usize size) {
+    if (is_mapped(size)) {
+        return align_up(size, page_size);
+    }
+    if (p == nullptr) {
+        return 0;
+    }
+
+#if defined(__GLIBC__)
+    return malloc_usable_size(p);
+#elif defined(__APPLE__)
+    return malloc_size(p);
+#else
+    return size;
+#endif
+}
+
+void maintain(usize iteration) {
+    if (trim_interval > 0 && (iteration % trim_interval) == 0) {
+        trim();
+    }
+}
+
+void *allocate(usize size) {
+    if (is_mapped(size)) {
+        return map_large(size);
+    }
+
+    // malloc instead of operator new, so blocks can be resized with realloc
+    void *p = std::malloc(size);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void deallocate(void *p, usize size) noexcept {
+    if (is_mapped(size)) {
+        munmap(p, align_up(size, page_size));
+        counters.live_mappings--;
+        return;
+    }
+
+    if ((release == RELEASE_DONTNEED || release == RELEASE_FREE) &&
+        size >= madvise_min) {
+        release_pages(p, size);
+    }
+    std::free(p);
+
+    if (trim_threshold > 0) {
+        if ((freed_since_trim += size) >= trim_threshold) {
+            trim();
+        }
+    }
+}
+
+static void *remap_large(void *p, usize old_size, usize new_size) {
+    usize old_len = align_up(old_size, page_size);
+    usize new_len = align_up(new_size, page_size);
+    if (old_len == new_len) {
+        return p;
+    }
+
+#if defined(MREMAP_MAYMOVE)
+    void *q = mremap(p, old_len, new_len, MREMAP_MAYMOVE);
+    if (q == MAP_FAILED) {
+        throw std::bad_alloc();
+    }
+    if (q != p) {
+        counters.resizes_remapped++;
+    }
+    return q;
+#else
+    void *q = map_large(new_size);
+    std::memcpy(q, p, (old_size < new_size) ? old_size : new_size);
+    deallocate(p, old_size);
+    counters.resizes_copied++;
+    return q;
+#endif
+}
+
+void *reallocate(void *p, usize old_size, usize new_size) {
+    auto start = std::chrono::steady_clock::now();
+
+    void *q;
+    if (is_mapped(old_size) && is_mapped(new_size)) {
+        q = remap_large(p, old_size, new_size);
+    } else if (!is_mapped(old_size) && !is_mapped(new_size)) {
+        q = std::realloc(p, new_size);
+        if (q == nullptr) {
+            throw std::bad_alloc();
+        }
+        if (q != p) {
+            counters.resizes_copied++;
+        }
+    } else {
+        // block crosses the threshold, move it to the other path
+        q = allocate(new_size);
+        std::memcpy(q, p, (old_size < new_size) ? old_size : new_size);
+        deallocate(p, old_size);
+        counters.resizes_copied++;
+    }
+
+    if (q == p) {
+        counters.resizes_in_place++;
+    }
+
+    counters.resize_time_ns +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+
+    return q;
+}
+
+} // namespace backend
@@ -0,0 +1,61 @@
+#ifndef BACKEND_HPP
+#define BACKEND_HPP
+
+#include "../../c/utils/args_parser.h"
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+
+namespace backend {
+
+/// Backend counters, exported with every tracker snapshot
+struct Stats {
+    usize live_mappings = 0;     // direct mappings currently alive
+    usize hugetlb_mappings = 0;  // total MAP_HUGETLB mappings
+    usize thp_mappings = 0;      // total madvise(MADV_HUGEPAGE) mappings
+    usize hugetlb_fallbacks = 0; // MAP_HUGETLB failed, fell back to THP
+
+    usize resizes_in_place = 0; // block kept its address
+    usize resizes_remapped = 0; // moved by mremap, pages were not copied
+    usize resizes_copied = 0;   // moved by copying the payload
+    usize resize_time_ns = 0;   // total time spent in `reallocate`
+
+    usize release_calls = 0;  // madvise calls on freed heap blocks
+    usize released_bytes = 0; // bytes handed back with madvise
+    usize trim_calls = 0;     // malloc_trim calls
+    usize trim_time_ns = 0;   // total time spent in malloc_trim
+};
+
+/// @brief Configure backend from arguments (call before first allocation)
+void init(const Args &args);
+
+/// @brief Allocate `size` bytes, blocks over the huge page threshold are
+///        mapped directly, everything else goes through the default heap
+void *allocate(usize size);
+
+/// @brief Release memory obtained by `allocate` with the same `size`
+void deallocate(void *p, usize size) noexcept;
+
+/// @brief Resize block with realloc semantics (contents are preserved up to
+///        the smaller size). Directly mapped blocks are moved with mremap
+void *reallocate(void *p, usize old_size, usize new_size);
+
+/// @brief Bytes the backend really reserved for a block of `size` bytes
+///        at `p` (malloc_usable_size for heap blocks, mapping length for
+///        directly mapped ones)
+usize usable_size(void *p, usize size);
+
+/// @brief Per iteration maintenance (periodic malloc_trim)
+void maintain(usize iteration);
+
+/// @brief Would a block of `size` bytes be mapped directly
+bool is_mapped(usize size);
+
+/// @brief Size of huge pages used for rounding direct mappings
+usize huge_page_size();
+
+Stats stats();
+
+} // namespace backend
+
+#endif // BACKEND_HPP
@@ -1,17 +1,19 @@
 #!/usr/bin/env bash
 
-FLAGS=" -std=c++20"
+CXX_FLAGS=" -std=c++20"
 
 FLAGS=" -Wall -Wpedantic -Wextra"
 FLAGS="$FLAGS -Wno-gnu-zero-variadic-macro-arguments -Wno-c++20-designator -Wno-unused-command-line-argument -Wno-unused-function"
 FLAGS="$FLAGS -Werror=implicit-function-declaration"
 
 MATH=" -lm"
+LIBS=" -ldl -pthread"
 
 DBG_FLAGS=" "
 
 CFILES=(../c/utils/args_parser.c)
-FILES=(main.cpp pool/pool.cpp random/random.cpp tracker/tracker.cpp actions/actions.cpp utils/progress.cpp)
+FILES=(main.cpp backend/backend.cpp pool/pool.cpp pool/shared_pool.cpp reclaim/reclaim.cpp random/random.cpp random/xoshiro.cpp random/alias.cpp random/inverse_cdf.cpp random/empirical.cpp random/markov.cpp tracker/tracker.cpp actions/actions.cpp actions/sites.cpp actions/schedule.cpp utils/progress.cpp scenario/monitor.cpp scenario/sharded.cpp scenario/handoff.cpp scenario/shared.cpp scenario/steal.cpp scenario/sessions.cpp scenario/processes.cpp scenario/cow.cpp)
+SHIM_FILES=(shim/shim.cpp)
 
 CC=clang
 # CC=gcc
@@ -21,5 +23,6 @@ CXX=clang++
 
 mkdir -p build
 
-$CC -c $FLAGS $DBG_FLAGS ${CFILES[@]} -o build/c-obj.o $MATH $*
-$CXX $FLAGS $DBG_FLAGS ${FILES[@]} build/c-obj.o -o build/cpp-test $MATH $*
\ No newline at end of file
+$CC -c -DARGS_CPP $FLAGS $DBG_FLAGS ${CFILES[@]} -o build/c-obj.o $MATH $*
+$CXX $CXX_FLAGS $FLAGS $DBG_FLAGS ${FILES[@]} build/c-obj.o -o build/cpp-test $MATH $LIBS $*
+$CXX $CXX_FLAGS $FLAGS $DBG_FLAGS -shared -fPIC ${SHIM_FILES[@]} -o build/libcpp-shim.so $*
\ No newline at end of file
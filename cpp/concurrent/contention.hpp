@@ -0,0 +1,22 @@
+#ifndef CONTENTION_HPP
+#define CONTENTION_HPP
+
+#include "../../c/utils/common.h"
+
+#include <atomic>
+
+namespace concurrent {
+
+/// Process wide contention counters, only touched on the slow path (failed
+/// CAS, lock already taken) and exported with every tracker snapshot
+struct Contention {
+    std::atomic<usize> cas_retries{0};
+    std::atomic<usize> lock_waits{0};   // acquisitions that had to wait
+    std::atomic<usize> lock_wait_ns{0}; // total time spent waiting
+};
+
+inline Contention contention;
+
+} // namespace concurrent
+
+#endif // CONTENTION_HPP
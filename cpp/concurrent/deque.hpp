@@ -0,0 +1,97 @@
+#ifndef DEQUE_HPP
+#define DEQUE_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+#include "contention.hpp"
+
+#include <atomic>
+
+namespace concurrent {
+
+/// Chase-Lev work-stealing deque of pointers with fixed capacity (memory
+/// orders follow Le et al., "Correct and Efficient Work-Stealing for Weak
+/// Memory Models"). The owner pushes and pops at the bottom, thieves take
+/// from the top
+template <class T> class StealDeque {
+  private:
+    std::unique_ptr<std::atomic<T *>[]> buffer;
+    isize mask;
+
+    alignas(64) std::atomic<isize> top{0};
+    alignas(64) std::atomic<isize> bottom{0};
+
+  public:
+    /// @param capacity power of 2
+    explicit StealDeque(usize capacity)
+        : buffer(new std::atomic<T *>[capacity]), mask((isize)capacity - 1) {
+        dbg_assert((capacity & (capacity - 1)) == 0);
+    }
+
+    StealDeque(const StealDeque &) = delete;
+    StealDeque &operator=(const StealDeque &) = delete;
+
+    /// @brief Owner only. Returns false when the deque is full
+    bool push(T *item) {
+        isize b = self.bottom.load(std::memory_order_relaxed);
+        isize t = self.top.load(std::memory_order_acquire);
+        if (b - t > self.mask) {
+            return false;
+        }
+
+        self.buffer[b & self.mask].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        self.bottom.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @brief Owner only, newest item first
+    T *pop() {
+        isize b = self.bottom.load(std::memory_order_relaxed) - 1;
+        self.bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        isize t = self.top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            self.bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T *item = self.buffer[b & self.mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // last item, race against thieves
+            if (!self.top.compare_exchange_strong(t, t + 1,
+                                                  std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            self.bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /// @brief Any thread, oldest item first. Returns nullptr when empty or
+    ///        when another thief won the race
+    T *steal() {
+        isize t = self.top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        isize b = self.bottom.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+
+        T *item = self.buffer[t & self.mask].load(std::memory_order_relaxed);
+        if (!self.top.compare_exchange_strong(t, t + 1,
+                                              std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+            contention.cas_retries.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        return item;
+    }
+};
+
+} // namespace concurrent
+
+#endif // DEQUE_HPP
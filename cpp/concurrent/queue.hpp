@@ -0,0 +1,133 @@
+#ifndef QUEUE_HPP
+#define QUEUE_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+#include "contention.hpp"
+#include "stack.hpp"
+
+#include <atomic>
+
+namespace concurrent {
+
+/// Lock-free FIFO of indices (Michael-Scott queue with counted pointers).
+/// Queue nodes come from a fixed array recycled through an `IndexStack`,
+/// the tags on `head`, `tail` and every `next` link protect against ABA
+/// the same way as in the original paper, so nodes never need deferred
+/// reclamation. Holds at most `capacity` values at a time
+class IndexQueue {
+  private:
+    struct Node {
+        std::atomic<Tagged> next;
+        std::atomic<u32> value;
+    };
+
+    std::unique_ptr<Node[]> nodes;
+    IndexStack free_nodes;
+
+    alignas(64) std::atomic<Tagged> head;
+    alignas(64) std::atomic<Tagged> tail;
+
+    static void retry() {
+        contention.cas_retries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+  public:
+    // one extra node is always the dummy at the head
+    explicit IndexQueue(usize capacity)
+        : nodes(new Node[capacity + 1]), free_nodes(capacity + 1) {
+        for (usize i = 0; i <= capacity; i++) {
+            self.nodes[i].next.store(tagged(NIL, 0), std::memory_order_relaxed);
+            self.nodes[i].value.store(NIL, std::memory_order_relaxed);
+        }
+        for (usize i = capacity; i > 0; i--) {
+            self.free_nodes.push((u32)i);
+        }
+        self.head.store(tagged(0, 0), std::memory_order_relaxed);
+        self.tail.store(tagged(0, 0), std::memory_order_relaxed);
+    }
+
+    void push(u32 value) {
+        u32 n;
+        if (!self.free_nodes.pop(n)) {
+            panic("IndexQueue holds more values than its capacity");
+        }
+
+        Node &node = self.nodes[n];
+        node.value.store(value, std::memory_order_relaxed);
+        Tagged old = node.next.load(std::memory_order_relaxed);
+        node.next.store(tagged(NIL, tag_of(old) + 1),
+                        std::memory_order_relaxed);
+
+        Tagged t;
+        while (true) {
+            t = self.tail.load(std::memory_order_acquire);
+            Tagged next =
+                self.nodes[index_of(t)].next.load(std::memory_order_acquire);
+            if (t != self.tail.load(std::memory_order_acquire)) {
+                retry();
+                continue;
+            }
+
+            if (index_of(next) == NIL) {
+                if (self.nodes[index_of(t)].next.compare_exchange_weak(
+                        next, tagged(n, tag_of(next) + 1),
+                        std::memory_order_release,
+                        std::memory_order_relaxed)) {
+                    break;
+                }
+                retry();
+            } else {
+                // tail is lagging behind, help the other producer
+                self.tail.compare_exchange_weak(
+                    t, tagged(index_of(next), tag_of(t) + 1),
+                    std::memory_order_release, std::memory_order_relaxed);
+            }
+        }
+
+        self.tail.compare_exchange_strong(t, tagged(n, tag_of(t) + 1),
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed);
+    }
+
+    bool pop(u32 &out) {
+        while (true) {
+            Tagged h = self.head.load(std::memory_order_acquire);
+            Tagged t = self.tail.load(std::memory_order_acquire);
+            Tagged next =
+                self.nodes[index_of(h)].next.load(std::memory_order_acquire);
+            if (h != self.head.load(std::memory_order_acquire)) {
+                retry();
+                continue;
+            }
+
+            if (index_of(h) == index_of(t)) {
+                if (index_of(next) == NIL) {
+                    return false;
+                }
+                self.tail.compare_exchange_weak(
+                    t, tagged(index_of(next), tag_of(t) + 1),
+                    std::memory_order_release, std::memory_order_relaxed);
+                continue;
+            }
+
+            // read before the CAS, afterwards the node may be recycled
+            u32 value = self.nodes[index_of(next)].value.load(
+                std::memory_order_relaxed);
+            if (self.head.compare_exchange_weak(
+                    h, tagged(index_of(next), tag_of(h) + 1),
+                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                // old dummy goes back, `next` is the new dummy
+                self.free_nodes.push(index_of(h));
+                out = value;
+                return true;
+            }
+            retry();
+        }
+    }
+};
+
+} // namespace concurrent
+
+#endif // QUEUE_HPP
@@ -0,0 +1,94 @@
+#ifndef RING_HPP
+#define RING_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+namespace concurrent {
+
+inline constexpr usize CACHE_LINE = 64;
+
+/// Bounded lock-free queue for many producers and one consumer (Vyukov).
+/// Every cell carries a sequence number, so producers only contend on the
+/// tail index and the consumer never does a read-modify-write
+template <class T> class MpscRing {
+  private:
+    struct alignas(CACHE_LINE) Cell {
+        std::atomic<usize> seq;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    usize mask;
+
+    alignas(CACHE_LINE) std::atomic<usize> tail{0};
+    alignas(CACHE_LINE) std::atomic<usize> head{0};
+
+  public:
+    /// @param capacity power of 2
+    explicit MpscRing(usize capacity)
+        : cells(new Cell[capacity]), mask(capacity - 1) {
+        dbg_assert((capacity & (capacity - 1)) == 0);
+        for (usize i = 0; i < capacity; i++) {
+            cells[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing &) = delete;
+    MpscRing &operator=(const MpscRing &) = delete;
+
+    /// @brief Returns false when the ring is full, `value` is left intact
+    bool try_push(T &value) {
+        usize pos = self.tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell &cell = self.cells[pos & self.mask];
+            usize seq = cell.seq.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+            if (diff == 0) {
+                if (self.tail.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = self.tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Only the owning consumer may pop
+    bool try_pop(T &out) {
+        usize pos = self.head.load(std::memory_order_relaxed);
+        Cell &cell = self.cells[pos & self.mask];
+        usize seq = cell.seq.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(pos + 1) < 0) {
+            return false;
+        }
+
+        out = std::move(cell.value);
+        cell.seq.store(pos + self.mask + 1, std::memory_order_release);
+        self.head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// @brief Number of queued items, exact only when nobody is pushing
+    usize size() const {
+        usize t = self.tail.load(std::memory_order_relaxed);
+        usize h = self.head.load(std::memory_order_relaxed);
+        return (t >= h) ? t - h : 0;
+    }
+
+    usize capacity() const { return self.mask + 1; }
+};
+
+} // namespace concurrent
+
+#endif // RING_HPP
@@ -0,0 +1,44 @@
+#ifndef SPINLOCK_HPP
+#define SPINLOCK_HPP
+
+#include "../utils/common.hpp"
+
+#include <atomic>
+
+namespace concurrent {
+
+/// @brief Tell the CPU we are busy waiting
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+/// Test-and-test-and-set lock, waiters spin on a plain load so the cache
+/// line stays shared until the owner releases it
+class SpinLock {
+  private:
+    std::atomic<bool> locked{false};
+
+  public:
+    bool try_lock() {
+        return !self.locked.load(std::memory_order_relaxed) &&
+               !self.locked.exchange(true, std::memory_order_acquire);
+    }
+
+    void lock() {
+        while (!self.try_lock()) {
+            while (self.locked.load(std::memory_order_relaxed)) {
+                cpu_relax();
+            }
+        }
+    }
+
+    void unlock() { self.locked.store(false, std::memory_order_release); }
+};
+
+} // namespace concurrent
+
+#endif // SPINLOCK_HPP
@@ -0,0 +1,70 @@
+#ifndef SPSC_HPP
+#define SPSC_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+
+#include <atomic>
+
+namespace concurrent {
+
+/// Wait-free bounded queue for exactly one producer and one consumer.
+/// Each side keeps a private copy of the other side's index and only
+/// reloads it when the ring looks full (or empty), so in the common case
+/// a push is one slot store plus one release store
+template <class T> class SpscRing {
+  private:
+    std::unique_ptr<T[]> slots;
+    usize mask;
+
+    alignas(64) std::atomic<usize> tail{0};
+    usize cached_head = 0; // producer's view of `head`
+
+    alignas(64) std::atomic<usize> head{0};
+    usize cached_tail = 0; // consumer's view of `tail`
+
+  public:
+    /// @param capacity power of 2
+    explicit SpscRing(usize capacity)
+        : slots(new T[capacity]), mask(capacity - 1) {
+        dbg_assert((capacity & (capacity - 1)) == 0);
+    }
+
+    SpscRing(const SpscRing &) = delete;
+    SpscRing &operator=(const SpscRing &) = delete;
+
+    /// @brief Producer only. Returns false when the ring is full
+    bool try_push(const T &value) {
+        usize t = self.tail.load(std::memory_order_relaxed);
+        if (t - self.cached_head > self.mask) {
+            self.cached_head = self.head.load(std::memory_order_acquire);
+            if (t - self.cached_head > self.mask) {
+                return false;
+            }
+        }
+
+        self.slots[t & self.mask] = value;
+        self.tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Consumer only
+    bool try_pop(T &out) {
+        usize h = self.head.load(std::memory_order_relaxed);
+        if (h == self.cached_tail) {
+            self.cached_tail = self.tail.load(std::memory_order_acquire);
+            if (h == self.cached_tail) {
+                return false;
+            }
+        }
+
+        out = self.slots[h & self.mask];
+        self.head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+} // namespace concurrent
+
+#endif // SPSC_HPP
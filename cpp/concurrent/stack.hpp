@@ -0,0 +1,75 @@
+#ifndef STACK_HPP
+#define STACK_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+#include "contention.hpp"
+
+#include <atomic>
+
+namespace concurrent {
+
+/// Tagged index: slot index in the low half, modification count in the
+/// high half. Every successful CAS bumps the tag, so an index that was
+/// popped and pushed back in the meantime no longer compares equal (ABA)
+using Tagged = u64;
+
+inline constexpr u32 NIL = (u32)-1;
+
+static inline constexpr Tagged tagged(u32 idx, u32 tag) {
+    return ((Tagged)tag << 32) | idx;
+}
+static inline constexpr u32 index_of(Tagged t) { return (u32)t; }
+static inline constexpr u32 tag_of(Tagged t) { return (u32)(t >> 32); }
+
+/// Lock-free LIFO of indices in [0, capacity) (Treiber stack). Links live
+/// in a fixed array that is never freed, so a stale reader only ever sees
+/// an outdated index and its CAS fails on the tag, no reclamation scheme
+/// is needed. An index may be in the stack at most once
+class IndexStack {
+  private:
+    std::unique_ptr<std::atomic<u32>[]> next;
+    alignas(64) std::atomic<Tagged> head{tagged(NIL, 0)};
+
+  public:
+    explicit IndexStack(usize capacity)
+        : next(new std::atomic<u32>[capacity]) {
+        dbg_assert(capacity < NIL);
+        for (usize i = 0; i < capacity; i++) {
+            self.next[i].store(NIL, std::memory_order_relaxed);
+        }
+    }
+
+    void push(u32 idx) {
+        Tagged h = self.head.load(std::memory_order_relaxed);
+        while (true) {
+            self.next[idx].store(index_of(h), std::memory_order_relaxed);
+            if (self.head.compare_exchange_weak(h, tagged(idx, tag_of(h) + 1),
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+                return;
+            }
+            contention.cas_retries.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool pop(u32 &out) {
+        Tagged h = self.head.load(std::memory_order_acquire);
+        while (index_of(h) != NIL) {
+            u32 n = self.next[index_of(h)].load(std::memory_order_relaxed);
+            if (self.head.compare_exchange_weak(h, tagged(n, tag_of(h) + 1),
+                                                std::memory_order_acquire,
+                                                std::memory_order_acquire)) {
+                out = index_of(h);
+                return true;
+            }
+            contention.cas_retries.fetch_add(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+};
+
+} // namespace concurrent
+
+#endif // STACK_HPP
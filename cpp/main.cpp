@@ -10,8 +10,13 @@
 #include "utils/progress.hpp"
 
 #include "actions/actions.hpp"
+#include "actions/schedule.hpp"
+#include "actions/sites.hpp"
+#include "backend/backend.hpp"
 #include "pool/pool.hpp"
 #include "random/random.hpp"
+#include "reclaim/reclaim.hpp"
+#include "scenario/scenario.hpp"
 #include "tracker/tracker.hpp"
 
 using Tracker = tracker::Tracker;
@@ -33,17 +38,61 @@ int main(int argc, char *argv[]) {
 #endif
     }
 
+    Random::set_generator((Rng)args.rng.as.e);
     rng = Random(args.seed.as.i);
+    backend::init(args);
+    reclaim::init(args);
+
+    // forked children publish into a CSV of their own layout
+    bool processes = args.processes.as.i > 0;
 
     Tracker &tracker = Tracker::instance();
-    if (output.is_open()) {
+    tracker.setUsableSize(args.slack_output.as.s != nullptr);
+    if (output.is_open() && !processes) {
         tracker.writeHeader(output);
         tracker.init();
         tracker.write(output);
     }
+    tracker.setTracking((Tracking)args.tracking.as.e, args.event_ring.as.i);
+    if ((args.reclaim.as.e != RECLAIM_IMMEDIATE) ||
+        (args.tracking.as.e != TRACKING_INLINE)) {
+        // reclaimer frees and aggregator applies events concurrently,
+        // read /proc only at snapshots
+        tracker.setSampleOnAlloc(false);
+    }
+    action::init_tables(args);
     action::init_actions(args);
-
-    {
+    sites::init(args);
+    schedule::init(args, rng);
+
+    if (processes) {
+        if (args.scenario.as.e == SCENARIO_COW) {
+            scenario::run_cow(args, output);
+        } else {
+            scenario::run_processes(args, output);
+        }
+    } else if (args.threads.as.i > 0) {
+        tracker.setSampleOnAlloc(false);
+        switch (args.scenario.as.e) {
+        case SCENARIO_SHARDED:
+            scenario::run_sharded(args, output);
+            break;
+        case SCENARIO_HANDOFF:
+            scenario::run_handoff(args, output);
+            break;
+        case SCENARIO_SHARED:
+            scenario::run_shared(args, output);
+            break;
+        case SCENARIO_STEAL:
+            scenario::run_steal(args, output);
+            break;
+        case SCENARIO_SESSIONS:
+            scenario::run_sessions(args, output);
+            break;
+        default:
+            panic("Unknown scenario %u", args.scenario.as.e);
+        }
+    } else {
         Pool pool = Pool(args.capacity.as.i);
 
         utils::ProgressBar progress =
@@ -55,25 +104,69 @@ int main(int argc, char *argv[]) {
 
         progress.display(args.display.as.b);
 
-        Int interval = (args.snap_interval.as.i > 0) ? args.snap_interval.as.i : 1;
-        while (progress.has_next()) {
-            usize i = progress.next();
-            action::block_action(pool, args, rng);
-
-            if (output.is_open() && ((i % interval) == 0)) {
-                tracker.write(output);
+        action::Loop loop = action::specialised_loop(args);
+        if (loop != nullptr) {
+            loop(pool, action::Params(args), rng, progress, output);
+        } else {
+            Int interval =
+                (args.snap_interval.as.i > 0) ? args.snap_interval.as.i : 1;
+            while (progress.has_next()) {
+                usize i = progress.next();
+                if (schedule::enabled()) {
+                    schedule::replay(pool, args);
+                } else if (sites::enabled()) {
+                    sites::block_action(args, rng);
+                } else {
+                    action::block_action(pool, args, rng);
+                }
+                backend::maintain(i);
+                reclaim::tick(i);
+
+                if (output.is_open() && ((i % interval) == 0)) {
+                    tracker.write(output);
+                }
             }
         }
 
         progress.finish();
 
-        free_args(&args);
+        if (schedule::enabled()) {
+            schedule::shutdown();
+            schedule::print_report();
+        }
+        if (sites::enabled()) {
+            sites::print_report();
+            sites::shutdown();
+        }
+    }
+
+    reclaim::shutdown();
+    if (args.reclaim.as.e != RECLAIM_IMMEDIATE) {
+        reclaim::print_report();
     }
-    
+
+    free_args(&args);
+    tracker.setTracking(TRACKING_INLINE, 0);
+
     if (output.is_open()) {
-        tracker.write(output);
+        if (!processes) {
+            tracker.write(output);
+        }
         output.flush();
         output.close();
     }
+
+    if (args.slack_output.as.s != nullptr) {
+        std::ofstream slack_output(args.slack_output.as.s,
+                                   std::ios::trunc | std::ios::out);
+        if (slack_output) {
+            tracker.writeSlackHistogram(slack_output);
+        }
+#if defined(LOG_LEVEL)
+        else {
+            perror(ERROR_STR " Could not open file");
+        }
+#endif
+    }
     return 0;
 }
@@ -1,6 +1,7 @@
 #include "pool.hpp"
 
 #include "../../c/utils/args_parser.h"
+#include "../reclaim/reclaim.hpp"
 
 #include <algorithm>
 
@@ -17,48 +18,48 @@ Block &Pool::add_block(usize size, SInt ttl) {
     return self.blocks.emplace_back(size, ttl);
 }
 
-void Pool::del_block(Policy policy, Random &rng) {
-    if (policy == POLICY_NEVER) {
-        return;
+Block &Pool::add_block(Block &&block) {
+    if (self.count() >= self.capacity) {
+        panic("Pool is at capacity. Cannot adopt new blocks.");
     }
 
-    if (self.blocks.size() == 0) {
-        return;
-    }
+    return self.blocks.emplace_back(std::move(block));
+}
 
+void Pool::del_block(Policy policy, Random &rng) {
     switch (policy) {
     case POLICY_LIFO:
-        self.blocks.pop_back();
-        break;
+        return del_block<POLICY_LIFO>(rng);
     case POLICY_FIFO:
-        self.blocks.pop_front();
-        break;
-    case POLICY_RANDOM: {
-        Int idx = rng.uniform(0, self.count());
-        auto p = self.blocks.begin();
-        for (Int i = 0; i < idx; i++, p++)
-            ;
-        self.blocks.erase(p);
-    } break;
-    case POLICY_BIG_FIRST: {
-        auto it = std::max_element(
-            self.blocks.begin(), self.blocks.end(),
-            [](Block &lhs, Block &rhs) { return lhs.size < rhs.size; });
-
-        self.blocks.erase(it);
-    } break;
-    case POLICY_SMALL_FIRST: {
-        auto it = std::min_element(
-            self.blocks.begin(), self.blocks.end(),
-            [](Block &lhs, Block &rhs) { return lhs.size < rhs.size; });
-
-        self.blocks.erase(it);
-    } break;
+        return del_block<POLICY_FIFO>(rng);
+    case POLICY_RANDOM:
+        return del_block<POLICY_RANDOM>(rng);
+    case POLICY_BIG_FIRST:
+        return del_block<POLICY_BIG_FIRST>(rng);
+    case POLICY_SMALL_FIRST:
+        return del_block<POLICY_SMALL_FIRST>(rng);
+    case POLICY_NEVER:
+        return del_block<POLICY_NEVER>(rng);
     default:
         panic("Unknown policy");
     }
 }
 
+void Pool::del_block_at(usize idx) {
+    dbg_assert(idx < self.count());
+
+    // victims go through `reclaim::retire`, erase only drops empty shells
+    auto it = self.blocks.begin() + idx;
+    reclaim::retire(std::move(*it));
+    self.blocks.erase(it);
+}
+
+Block &Pool::resize_block(usize idx, usize size) {
+    Block &block = self[idx];
+    block.resize(size);
+    return block;
+}
+
 void Pool::update_and_prune() {
     auto it = self.blocks.begin();
     while (it != self.blocks.end()) {
@@ -67,6 +68,7 @@ void Pool::update_and_prune() {
         }
 
         if (it->ttl == 0) {
+            reclaim::retire(std::move(*it));
             it = self.blocks.erase(it);
         } else {
             it++;
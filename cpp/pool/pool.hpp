@@ -7,6 +7,8 @@
 #include "../random/random.hpp"
 #include "../utils/common.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <queue>
 
 #define DBG_BLOCK_STR                                                          \
@@ -17,24 +19,98 @@
 namespace block {
 template <class ByteAlloc = std::allocator<u8>> struct Block {
     using allocator_type = ByteAlloc;
+    using traits = std::allocator_traits<ByteAlloc>;
 
-    std::vector<u8, ByteAlloc> data;
+    [[no_unique_address]] ByteAlloc alloc;
+    u8 *data;
     Int size;
     SInt ttl;
     SInt ttl_org;
 
     Block(std::allocator_arg_t, const ByteAlloc &a, Int sz)
-        : Block(a, sz, -1) {}
+        : Block(std::allocator_arg, a, sz, -1) {}
 
     Block(std::allocator_arg_t, const ByteAlloc &a, Int sz, SInt ttl_)
-        : data(a), size(sz), ttl(ttl_), ttl_org(ttl_) {
-        data.resize(size, 0);
+        : alloc(a), data(nullptr), size(sz), ttl(ttl_), ttl_org(ttl_) {
+        fill();
     }
 
+    Block() : alloc(), data(nullptr), size(0), ttl(-1), ttl_org(-1) {}
+
     explicit Block(Int sz) : Block(sz, -1) {}
     explicit Block(Int sz, SInt ttl_)
-        : data(), size(sz), ttl(ttl_), ttl_org(ttl_) {
-        data.resize(size, 0);
+        : alloc(), data(nullptr), size(sz), ttl(ttl_), ttl_org(ttl_) {
+        fill();
+    }
+
+    Block(const Block &) = delete;
+    Block &operator=(const Block &) = delete;
+
+    Block(Block &&other) noexcept
+        : alloc(other.alloc), data(other.data), size(other.size),
+          ttl(other.ttl), ttl_org(other.ttl_org) {
+        other.data = nullptr;
+        other.size = 0;
+    }
+
+    Block &operator=(Block &&other) noexcept {
+        if (this != &other) {
+            release();
+            data = other.data;
+            size = other.size;
+            ttl = other.ttl;
+            ttl_org = other.ttl_org;
+            other.data = nullptr;
+            other.size = 0;
+        }
+        return self;
+    }
+
+    ~Block() { release(); }
+
+    /// @brief Grow or shrink payload with realloc semantics. Uses
+    ///        `ByteAlloc::reallocate` when the allocator provides one,
+    ///        otherwise allocates a new buffer and copies (copy-on-grow)
+    void resize(Int new_size) {
+        if (new_size == size) {
+            return;
+        }
+        if (data == nullptr || new_size == 0) {
+            release();
+            size = new_size;
+            fill();
+            return;
+        }
+
+        u8 *p;
+        if constexpr (requires { alloc.reallocate(data, size, new_size); }) {
+            p = alloc.reallocate(data, size, new_size);
+        } else {
+            p = traits::allocate(alloc, new_size);
+            std::memcpy(p, data, std::min(size, new_size));
+            traits::deallocate(alloc, data, size);
+        }
+
+        if (new_size > size) {
+            std::memset(p + size, 0, new_size - size);
+        }
+        data = p;
+        size = new_size;
+    }
+
+  private:
+    void fill() {
+        if (size > 0) {
+            data = traits::allocate(alloc, size);
+            std::memset(data, 0, size);
+        }
+    }
+
+    void release() {
+        if (data != nullptr) {
+            traits::deallocate(alloc, data, size);
+            data = nullptr;
+        }
     }
 };
 } // namespace block
@@ -51,7 +127,45 @@ struct Pool {
     Pool(const Pool &) = delete;
 
     Block &add_block(usize size, SInt ttl = -1L);
+    Block &add_block(Block &&block);
     void del_block(Policy policy, Random &rng);
+    /// @brief Evict the block at `idx`, for victims chosen ahead of time
+    void del_block_at(usize idx);
+
+    /// @brief `del_block` with the policy fixed at compile time
+    template <Policy P> void del_block(Random &rng) {
+        if constexpr (P == POLICY_NEVER) {
+            return;
+        } else {
+            if (self.blocks.empty()) {
+                return;
+            }
+
+            auto by_size = [](const Block &lhs, const Block &rhs) {
+                return lhs.size < rhs.size;
+            };
+
+            usize idx;
+            if constexpr (P == POLICY_LIFO) {
+                idx = self.count() - 1;
+            } else if constexpr (P == POLICY_FIFO) {
+                idx = 0;
+            } else if constexpr (P == POLICY_RANDOM) {
+                idx = rng.uniform(0, self.count());
+            } else if constexpr (P == POLICY_BIG_FIRST) {
+                idx = std::max_element(self.blocks.begin(), self.blocks.end(),
+                                       by_size) -
+                      self.blocks.begin();
+            } else {
+                static_assert(P == POLICY_SMALL_FIRST, "Unknown policy");
+                idx = std::min_element(self.blocks.begin(), self.blocks.end(),
+                                       by_size) -
+                      self.blocks.begin();
+            }
+            del_block_at(idx);
+        }
+    }
+    Block &resize_block(usize idx, usize size);
 
     void update_and_prune();
 
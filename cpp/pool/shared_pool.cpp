@@ -0,0 +1,142 @@
+#include "shared_pool.hpp"
+
+#include "../reclaim/reclaim.hpp"
+
+#include <chrono>
+
+SharedPool::SharedPool(Int capacity, Policy policy, Lock lock)
+    : policy(policy), lock_kind(lock), pool(capacity), capacity(capacity) {
+    if (!self.is_lock_free()) {
+        return;
+    }
+
+    self.slots = std::make_unique<Block[]>(capacity);
+    self.free_slots = std::make_unique<concurrent::IndexStack>(capacity);
+    for (usize i = capacity; i > 0; i--) {
+        self.free_slots->push((u32)(i - 1));
+    }
+
+    if (policy == POLICY_LIFO) {
+        self.stack = std::make_unique<concurrent::IndexStack>(capacity);
+    } else {
+        self.queue = std::make_unique<concurrent::IndexQueue>(capacity);
+    }
+}
+
+void SharedPool::lock() {
+    bool acquired = (self.lock_kind == LOCK_SPIN) ? self.spin.try_lock()
+                                                  : self.mutex.try_lock();
+    if (acquired) {
+        return;
+    }
+
+    // only contended acquisitions pay for the clock
+    auto start = std::chrono::steady_clock::now();
+    if (self.lock_kind == LOCK_SPIN) {
+        self.spin.lock();
+    } else {
+        self.mutex.lock();
+    }
+
+    concurrent::contention.lock_waits.fetch_add(1, std::memory_order_relaxed);
+    concurrent::contention.lock_wait_ns.fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count(),
+        std::memory_order_relaxed);
+}
+
+void SharedPool::unlock() {
+    if (self.lock_kind == LOCK_SPIN) {
+        self.spin.unlock();
+    } else {
+        self.mutex.unlock();
+    }
+}
+
+void SharedPool::push(u32 idx) {
+    if (self.stack) {
+        self.stack->push(idx);
+    } else {
+        self.queue->push(idx);
+    }
+}
+
+bool SharedPool::pop(u32 &idx) {
+    return self.stack ? self.stack->pop(idx) : self.queue->pop(idx);
+}
+
+bool SharedPool::add_block(Block &&block) {
+    if (!self.is_lock_free()) {
+        self.lock();
+        bool added = self.pool.count() < self.pool.capacity;
+        if (added) {
+            self.pool.add_block(std::move(block));
+            self.live.store(self.pool.count(), std::memory_order_relaxed);
+        }
+        self.unlock();
+        return added;
+    }
+
+    u32 idx;
+    if (!self.free_slots->pop(idx)) {
+        return false;
+    }
+
+    // slot is exclusively ours until it is published by `push`
+    self.live.fetch_add(1, std::memory_order_relaxed);
+    self.slots[idx] = std::move(block);
+    self.push(idx);
+    return true;
+}
+
+void SharedPool::del_block(Random &rng) {
+    if (!self.is_lock_free()) {
+        self.lock();
+        self.pool.del_block(self.policy, rng);
+        self.live.store(self.pool.count(), std::memory_order_relaxed);
+        self.unlock();
+        return;
+    }
+
+    u32 idx;
+    if (!self.pop(idx)) {
+        return;
+    }
+
+    // count the slot as taken until it is really back on the free list
+    reclaim::retire(std::move(self.slots[idx]));
+    self.free_slots->push(idx);
+    self.live.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void SharedPool::resize_block(usize size, Random &rng) {
+    if (!self.is_lock_free()) {
+        self.lock();
+        if (self.pool.count() > 0) {
+            usize idx = rng.uniform(0, self.pool.count());
+            self.pool.resize_block(idx, size);
+        }
+        self.unlock();
+        return;
+    }
+
+    u32 idx;
+    if (!self.pop(idx)) {
+        return;
+    }
+
+    self.slots[idx].resize(size);
+    self.push(idx);
+}
+
+void SharedPool::update_and_prune() {
+    if (self.is_lock_free()) {
+        return;
+    }
+
+    self.lock();
+    self.pool.update_and_prune();
+    self.live.store(self.pool.count(), std::memory_order_relaxed);
+    self.unlock();
+}
@@ -0,0 +1,67 @@
+#ifndef SHARED_POOL_HPP
+#define SHARED_POOL_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../concurrent/queue.hpp"
+#include "../concurrent/spinlock.hpp"
+#include "../concurrent/stack.hpp"
+#include "pool.hpp"
+
+#include <mutex>
+
+/// Pool shared by all worker threads. LIFO and FIFO are lock-free (Treiber
+/// stack / Michael-Scott queue of slot indices, blocks stay in a fixed slot
+/// array), every other policy wraps a plain `Pool` in a mutex or spinlock
+struct SharedPool {
+  private:
+    Policy policy;
+    Lock lock_kind;
+
+    // lock-free variant
+    std::unique_ptr<Block[]> slots;
+    std::unique_ptr<concurrent::IndexStack> free_slots;
+    std::unique_ptr<concurrent::IndexStack> stack;
+    std::unique_ptr<concurrent::IndexQueue> queue;
+
+    // lock based variant
+    Pool pool;
+    std::mutex mutex;
+    concurrent::SpinLock spin;
+
+    alignas(64) std::atomic<usize> live{0};
+
+    void lock();
+    void unlock();
+
+    void push(u32 idx);
+    bool pop(u32 &idx);
+
+  public:
+    Int capacity;
+
+    SharedPool(Int capacity, Policy policy, Lock lock);
+    SharedPool(const SharedPool &) = delete;
+
+    bool is_lock_free() const {
+        return self.policy == POLICY_LIFO || self.policy == POLICY_FIFO;
+    }
+
+    /// @brief Take ownership of `block`. Returns false (and leaves `block`
+    ///        alone) when every slot is taken
+    bool add_block(Block &&block);
+
+    /// @brief Free one block chosen by the policy
+    void del_block(Random &rng);
+
+    /// @brief Resize one block, lock-free variants take the next block the
+    ///        policy would free and put it back afterwards
+    void resize_block(usize size, Random &rng);
+
+    /// @brief TTL bookkeeping, only supported by the lock based variant
+    void update_and_prune();
+
+    usize count() const { return self.live.load(std::memory_order_relaxed); }
+};
+
+#endif // SHARED_POOL_HPP
@@ -0,0 +1,66 @@
+#include "alias.hpp"
+
+AliasTable::AliasTable(const IntList &l, const IntList &weights)
+    : AliasTable(std::vector<Int>(l.items, l.items + l.count),
+                 std::vector<double>(weights.items,
+                                     weights.items + weights.count)) {}
+
+AliasTable::AliasTable(std::vector<Int> values_,
+                       const std::vector<double> &weights) {
+    usize n = values_.size();
+    if (n == 0) {
+        return;
+    }
+    dbg_assert(weights.empty() || weights.size() == n);
+
+    double sum = 0.0;
+    for (double w : weights) {
+        sum += w;
+    }
+    if (!weights.empty() && sum == 0.0) {
+        fatal("Weights should not all be zero");
+    }
+
+    values = std::move(values_);
+    prob.assign(n, 1.0);
+    alias.resize(n);
+
+    // scaled weights, 1.0 is the average column
+    std::vector<double> scaled(n, 1.0);
+    for (usize i = 0; i < weights.size(); i++) {
+        scaled[i] = weights[i] * (double)n / sum;
+    }
+
+    std::vector<u32> small, large;
+    for (usize i = 0; i < n; i++) {
+        alias[i] = (u32)i;
+        if (scaled[i] < 1.0) {
+            small.push_back((u32)i);
+        } else {
+            large.push_back((u32)i);
+        }
+    }
+
+    while (!small.empty() && !large.empty()) {
+        u32 s = small.back();
+        u32 g = large.back();
+        small.pop_back();
+
+        prob[s] = scaled[s];
+        alias[s] = g;
+
+        scaled[g] = (scaled[g] + scaled[s]) - 1.0;
+        if (scaled[g] < 1.0) {
+            large.pop_back();
+            small.push_back(g);
+        }
+    }
+
+    // leftovers are 1.0 up to rounding
+    for (u32 i : large) {
+        prob[i] = 1.0;
+    }
+    for (u32 i : small) {
+        prob[i] = 1.0;
+    }
+}
@@ -0,0 +1,40 @@
+#ifndef ALIAS_HPP
+#define ALIAS_HPP
+
+#include "../../c/utils/common.h"
+#include "../../c/utils/list.h"
+
+#include "../utils/common.hpp"
+
+#include "random.hpp"
+
+#include <vector>
+
+/// Walker/Vose alias table: weighted choice in O(1) with one uniform draw,
+/// built once in O(n) from a list and its weights
+struct AliasTable {
+    std::vector<Int> values;
+    std::vector<double> prob; // keep column `i` with this probability
+    std::vector<u32> alias;   // otherwise take this column
+
+    AliasTable() = default;
+
+    /// @brief Empty `weights` means every value is equally likely
+    AliasTable(const IntList &l, const IntList &weights);
+    AliasTable(std::vector<Int> values, const std::vector<double> &weights);
+
+    bool empty() const { return values.empty(); }
+
+    /// @brief Position in `values` drawn by weight
+    u32 sample_index(Random &rng) const {
+        dbg_assert(!values.empty());
+
+        double u = rng.uniform01() * (double)values.size();
+        u32 i = (u32)u;
+        return (u - i < prob[i]) ? i : alias[i];
+    }
+
+    Int sample(Random &rng) const { return values[sample_index(rng)]; }
+};
+
+#endif // ALIAS_HPP
@@ -0,0 +1,185 @@
+#include "empirical.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+
+// Raw samples with at most this many distinct sizes keep one bucket per
+// size, more are binned into 8 classes per power of two
+static constexpr usize MAX_EXACT = 1024;
+
+/// @brief Size class of raw sample `v`, at most 12.5% wide
+static std::pair<Int, Int> size_class(Int v) {
+    if (v < 16) {
+        return {v, v};
+    }
+    int shift = (63 - __builtin_clzll(v)) - 3;
+    Int base = (v >> shift) << shift;
+    return {base, base + (1ULL << shift) - 1};
+}
+
+bool parse_number_line(std::string line, std::vector<Int> &out) {
+    usize hash = line.find('#');
+    if (hash != std::string::npos) {
+        line.resize(hash);
+    }
+
+    out.clear();
+    const char *p = line.c_str();
+    while (*p != '\0') {
+        if (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r') {
+            p++;
+            continue;
+        }
+
+        if (*p == '-') {
+            return false; // strtoull would wrap it around
+        }
+
+        char *end;
+        errno = 0;
+        unsigned long long v = strtoull(p, &end, 10);
+        if (end == p || errno != 0) {
+            return false;
+        }
+        out.push_back((Int)v);
+        p = end;
+    }
+    return true;
+}
+
+bool parse_weight_line(std::string line, std::vector<double> &out) {
+    usize hash = line.find('#');
+    if (hash != std::string::npos) {
+        line.resize(hash);
+    }
+
+    out.clear();
+    const char *p = line.c_str();
+    while (*p != '\0') {
+        if (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r') {
+            p++;
+            continue;
+        }
+
+        char *end;
+        errno = 0;
+        double v = strtod(p, &end);
+        if (end == p || errno != 0 || !std::isfinite(v) || v < 0.0) {
+            return false;
+        }
+        out.push_back(v);
+        p = end;
+    }
+    return true;
+}
+
+Empirical Empirical::load(const char *path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fatal("Could not open distribution file %s: %s", path,
+              strerror(errno));
+    }
+
+    Empirical e;
+    std::vector<double> counts;
+    std::map<Int, usize> samples;
+
+    std::string line;
+    std::vector<Int> fields;
+    usize lineno = 0;
+    while (std::getline(file, line)) {
+        lineno++;
+        if (!parse_number_line(line, fields)) {
+            fatal("%s:%zu: expected numbers", path, lineno);
+        }
+
+        switch (fields.size()) {
+        case 0:
+            break;
+        case 1:
+            samples[fields[0]]++;
+            break;
+        case 3:
+            if (fields[0] > fields[1]) {
+                fatal("%s:%zu: bucket bounds %zu > %zu", path, lineno,
+                      fields[0], fields[1]);
+            }
+            e.lo.push_back(fields[0]);
+            e.hi.push_back(fields[1]);
+            counts.push_back((double)fields[2]);
+            break;
+        default:
+            fatal("%s:%zu: expected `LO HI COUNT` or a single size", path,
+                  lineno);
+        }
+    }
+
+    if (!samples.empty() && !e.lo.empty()) {
+        fatal("%s: mixes histogram buckets and raw sizes", path);
+    }
+
+    if (!samples.empty()) {
+        std::map<std::pair<Int, Int>, usize> classes;
+        for (const auto &[size, n] : samples) {
+            auto bucket = (samples.size() <= MAX_EXACT)
+                              ? std::pair<Int, Int>{size, size}
+                              : size_class(size);
+            classes[bucket] += n;
+        }
+        for (const auto &[bucket, n] : classes) {
+            e.lo.push_back(bucket.first);
+            e.hi.push_back(bucket.second);
+            counts.push_back((double)n);
+        }
+    }
+
+    if (e.lo.empty()) {
+        fatal("%s: no sizes", path);
+    }
+
+    // buckets in size order, so `at` can walk the cumulative counts
+    std::vector<usize> order(e.lo.size());
+    for (usize b = 0; b < order.size(); b++) {
+        order[b] = b;
+    }
+    std::stable_sort(order.begin(), order.end(),
+                     [&](usize a, usize b) { return e.lo[a] < e.lo[b]; });
+
+    Empirical sorted;
+    std::vector<double> weights;
+    double total = 0.0;
+    for (usize b : order) {
+        sorted.lo.push_back(e.lo[b]);
+        sorted.hi.push_back(e.hi[b]);
+        weights.push_back(counts[b]);
+        total += counts[b];
+        sorted.cumulative.push_back(total);
+    }
+
+    std::vector<Int> positions(order.size());
+    for (usize b = 0; b < positions.size(); b++) {
+        positions[b] = b;
+    }
+    sorted.buckets = AliasTable(std::move(positions), weights);
+
+    return sorted;
+}
+
+Int Empirical::at(double u) const {
+    double target = u * cumulative.back();
+    usize b = std::upper_bound(cumulative.begin(), cumulative.end(), target) -
+              cumulative.begin();
+    b = std::min(b, cumulative.size() - 1);
+
+    double start = (b > 0) ? cumulative[b - 1] : 0.0;
+    double weight = cumulative[b] - start;
+    double f = (weight > 0.0) ? (target - start) / weight : 0.0;
+
+    Int size = lo[b] + (Int)(f * (double)(hi[b] - lo[b] + 1));
+    return std::min(size, hi[b]);
+}
@@ -0,0 +1,47 @@
+#ifndef EMPIRICAL_HPP
+#define EMPIRICAL_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+
+#include "alias.hpp"
+#include "random.hpp"
+
+#include <string>
+#include <vector>
+
+/// @brief Split one line of a size file into numbers. Spaces and commas
+///        separate fields, `#` starts a comment. False on anything else
+bool parse_number_line(std::string line, std::vector<Int> &out);
+
+/// @brief Same for weights, which may be fractional. False on negative or
+///        non finite ones
+bool parse_weight_line(std::string line, std::vector<double> &out);
+
+/// Size distribution replayed from a histogram: a bucket is drawn by its
+/// count through an alias table, the size uniformly inside the bucket
+struct Empirical {
+    std::vector<Int> lo, hi;        // inclusive bucket bounds, by size
+    std::vector<double> cumulative; // running count up to each bucket
+    AliasTable buckets;             // values are bucket positions
+
+    Empirical() = default;
+
+    /// @brief Read `path`, every line is either `LO HI COUNT` (histogram
+    ///        bucket) or a single size (raw sample, binned here). Fields
+    ///        may be separated by spaces or commas, `#` starts a comment
+    static Empirical load(const char *path);
+
+    bool empty() const { return buckets.empty(); }
+
+    Int sample(Random &rng) const {
+        u32 b = buckets.sample_index(rng);
+        return (lo[b] == hi[b]) ? lo[b] : rng.uniform(lo[b], hi[b] + 1);
+    }
+
+    /// @brief Size at quantile `u` in [0, 1], for correlated draws
+    Int at(double u) const;
+};
+
+#endif // EMPIRICAL_HPP
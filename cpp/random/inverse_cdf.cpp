@@ -0,0 +1,106 @@
+#include "inverse_cdf.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/// Analytic distribution behind one table, same formulas as `Random`
+struct Shape {
+    Distribution distribution;
+    double min, max, param;
+    bool log_uniform; // powerlaw with alpha == 1
+
+    /// @brief Unclamped quantile
+    double quantile(double u) const {
+        if (distribution == DISTRIBUTION_EXP) {
+            return -std::log(1.0 - u) / param;
+        }
+        if (log_uniform) {
+            return min * std::pow(max / min, u);
+        }
+        double e = 1.0 - param;
+        double min_e = std::pow(min, e);
+        double max_e = std::pow(max, e);
+        return std::pow(min_e + u * (max_e - min_e), 1.0 / e);
+    }
+
+    /// @brief CDF on [min, max), clamped mass below `min` included
+    double cdf(double y) const {
+        if (distribution == DISTRIBUTION_EXP) {
+            return 1.0 - std::exp(-param * y);
+        }
+        if (log_uniform) {
+            return std::log(y / min) / std::log(max / min);
+        }
+        double e = 1.0 - param;
+        return (std::pow(y, e) - std::pow(min, e)) /
+               (std::pow(max, e) - std::pow(min, e));
+    }
+
+    /// @brief Size where the density equals `slope`
+    double density_at(double slope) const {
+        if (distribution == DISTRIBUTION_EXP) {
+            return -std::log(slope / param) / param;
+        }
+        if (log_uniform) {
+            return 1.0 / (slope * std::log(max / min));
+        }
+        double e = 1.0 - param;
+        double span = std::pow(max, e) - std::pow(min, e);
+        return std::pow(slope * span / e, 1.0 / (e - 1.0));
+    }
+};
+
+/// @brief Largest |F - F_table| on one rising segment. The analytic CDF
+///        is concave or convex there, so the extremum of the difference
+///        to the chord is at an end or where the slopes match
+static double segment_ks(const Shape &shape, double y0, double y1, double u0,
+                         double u1) {
+    double slope = (u1 - u0) / (y1 - y0);
+    auto chord = [&](double y) { return u0 + slope * (y - y0); };
+
+    double d = std::max(std::fabs(shape.cdf(y0) - u0),
+                        std::fabs(shape.cdf(y1) - u1));
+    double y = shape.density_at(slope);
+    if (std::isfinite(y) && y > y0 && y < y1) {
+        d = std::max(d, std::fabs(shape.cdf(y) - chord(y)));
+    }
+    return d;
+}
+
+InverseCdf::InverseCdf(Distribution distribution, Int min, Int max,
+                       Float param, usize intervals) {
+    if (distribution != DISTRIBUTION_EXP &&
+        distribution != DISTRIBUTION_POWERLAW) {
+        return;
+    }
+    if (min >= max || intervals == 0) {
+        return;
+    }
+
+    Shape shape = {distribution, (double)min, (double)max, (double)param,
+                   std::fabs(param - 1.0) < 1e-8};
+
+    nodes.resize(intervals + 1);
+    for (usize i = 0; i <= intervals; i++) {
+        double u = (double)i / (double)intervals;
+        double q = (i == intervals && distribution == DISTRIBUTION_EXP)
+                       ? shape.max // quantile of 1 is infinite
+                       : shape.quantile(u);
+        if (std::isnan(q)) {
+            log_warn("Inverse-CDF table is undefined for these parameters, "
+                     "using the analytic sampler");
+            nodes.clear();
+            return;
+        }
+        nodes[i] = std::clamp(q, shape.min, shape.max);
+    }
+
+    ks = 0.0;
+    for (usize i = 0; i < intervals; i++) {
+        if (nodes[i + 1] > nodes[i]) {
+            double u0 = (double)i / (double)intervals;
+            double u1 = (double)(i + 1) / (double)intervals;
+            ks = std::max(ks, segment_ks(shape, nodes[i], nodes[i + 1], u0, u1));
+        }
+    }
+}
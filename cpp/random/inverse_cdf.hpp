@@ -0,0 +1,37 @@
+#ifndef INVERSE_CDF_HPP
+#define INVERSE_CDF_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+
+#include "random.hpp"
+
+#include <vector>
+
+/// Quantile function of `Random::exponential` / `Random::powerlaw` sampled
+/// at N + 1 equally spaced probabilities and linearly interpolated. Both
+/// CDFs agree at every node and are monotone in between, so the KS
+/// distance to the analytic distribution is at most 1/N. The exact value
+/// is computed at build time (`ks`)
+struct InverseCdf {
+    std::vector<double> nodes; // Q(i / N), already clamped to [min, max]
+    double ks = 0.0;           // sup |F - F_table| over all sizes
+
+    InverseCdf() = default;
+    InverseCdf(Distribution distribution, Int min, Int max, Float param,
+               usize intervals);
+
+    bool empty() const { return nodes.empty(); }
+
+    Int sample(Random &rng) const {
+        dbg_assert(nodes.size() > 1);
+
+        double u = rng.uniform01() * (double)(nodes.size() - 1);
+        usize i = (usize)u;
+        double x = nodes[i] + (u - (double)i) * (nodes[i + 1] - nodes[i]);
+        return (Int)x;
+    }
+};
+
+#endif // INVERSE_CDF_HPP
@@ -0,0 +1,209 @@
+#include "markov.hpp"
+
+#include "empirical.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+// Trace sizes without a --size-list become states, up to this many
+static constexpr usize MAX_STATES = 1024;
+
+/// @brief Stationary distribution by power iteration on the lazy chain
+///        (I + P) / 2, which has the same fixed point but also converges
+///        for periodic chains
+static std::vector<double> solve_stationary(const std::vector<double> &p,
+                                            usize n) {
+    std::vector<double> pi(n, 1.0 / (double)n);
+    std::vector<double> next(n);
+
+    // bounded work for large matrices, converged long before for most
+    usize iterations = std::clamp<usize>(100000000 / (n * n), 100, 10000);
+    for (usize iter = 0; iter < iterations; iter++) {
+        for (usize j = 0; j < n; j++) {
+            next[j] = 0.5 * pi[j];
+        }
+        for (usize i = 0; i < n; i++) {
+            for (usize j = 0; j < n; j++) {
+                next[j] += 0.5 * pi[i] * p[i * n + j];
+            }
+        }
+
+        double delta = 0.0;
+        for (usize j = 0; j < n; j++) {
+            delta += std::fabs(next[j] - pi[j]);
+        }
+        pi.swap(next);
+        if (delta < 1e-12) {
+            break;
+        }
+    }
+    return pi;
+}
+
+MarkovChain MarkovChain::build(std::vector<Int> sizes,
+                               const std::vector<double> &weights,
+                               std::vector<double> stationary) {
+    usize n = sizes.size();
+    dbg_assert(weights.size() == n * n);
+
+    MarkovChain chain;
+    std::vector<double> p(n * n, 0.0); // row normalised
+    chain.stay.assign(n, 0.0);
+    for (usize i = 0; i < n; i++) {
+        std::vector<double> row(weights.begin() + i * n,
+                                weights.begin() + (i + 1) * n);
+        double sum = 0.0;
+        for (double w : row) {
+            sum += w;
+        }
+
+        if (sum == 0.0) {
+            chain.rows.emplace_back(); // never left, restart from `start`
+            continue;
+        }
+        for (usize j = 0; j < n; j++) {
+            p[i * n + j] = row[j] / sum;
+        }
+        chain.stay[i] = p[i * n + i];
+
+        std::vector<Int> states(n);
+        for (usize j = 0; j < n; j++) {
+            states[j] = j;
+        }
+        chain.rows.emplace_back(std::move(states), row);
+    }
+
+    if (stationary.empty()) {
+        stationary = solve_stationary(p, n);
+    }
+
+    std::vector<Int> states(n);
+    for (usize j = 0; j < n; j++) {
+        states[j] = j;
+    }
+    chain.start = AliasTable(std::move(states), stationary);
+    chain.stationary = std::move(stationary);
+    chain.sizes = std::move(sizes);
+    return chain;
+}
+
+MarkovChain MarkovChain::from_matrix(const IntList &sizes,
+                                     const std::vector<double> &weights) {
+    usize n = sizes.count;
+    for (usize i = 0; i < n; i++) {
+        double sum = 0.0;
+        for (usize j = 0; j < n; j++) {
+            sum += weights[i * n + j];
+        }
+        if (sum == 0.0) {
+            fatal("Row %zu of the Markov matrix is all zero", i);
+        }
+    }
+
+    return build(std::vector<Int>(sizes.items, sizes.items + n), weights, {});
+}
+
+MarkovChain MarkovChain::from_file(const IntList &sizes, const char *path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fatal("Could not open Markov matrix %s: %s", path, strerror(errno));
+    }
+
+    usize n = sizes.count;
+    std::vector<double> weights;
+    std::string line;
+    std::vector<double> fields;
+    usize lineno = 0;
+    while (std::getline(file, line)) {
+        lineno++;
+        if (!parse_weight_line(line, fields)) {
+            fatal("%s:%zu: expected non-negative weights", path, lineno);
+        }
+        if (fields.empty()) {
+            continue;
+        }
+        if (fields.size() != n) {
+            fatal("%s:%zu: expected %zu weights, one per size, got %zu", path,
+                  lineno, n, fields.size());
+        }
+        weights.insert(weights.end(), fields.begin(), fields.end());
+    }
+
+    if (weights.size() != n * n) {
+        fatal("%s: expected %zu rows, got %zu", path, n, weights.size() / n);
+    }
+    return from_matrix(sizes, weights);
+}
+
+MarkovChain MarkovChain::from_trace(const IntList &sizes, const char *path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        fatal("Could not open size trace %s: %s", path, strerror(errno));
+    }
+
+    std::vector<Int> trace;
+    std::string line;
+    std::vector<Int> fields;
+    usize lineno = 0;
+    while (std::getline(file, line)) {
+        lineno++;
+        if (!parse_number_line(line, fields) || fields.size() > 1) {
+            fatal("%s:%zu: expected one size per line", path, lineno);
+        }
+        if (!fields.empty()) {
+            trace.push_back(fields[0]);
+        }
+    }
+    if (trace.empty()) {
+        fatal("%s: no sizes", path);
+    }
+
+    // states sorted by size, trace entries snap to the nearest one
+    std::vector<Int> states(sizes.items, sizes.items + sizes.count);
+    if (states.empty()) {
+        states = trace;
+    }
+    std::sort(states.begin(), states.end());
+    states.erase(std::unique(states.begin(), states.end()), states.end());
+    if (states.size() > MAX_STATES) {
+        fatal("%s: %zu distinct sizes, give a --size-list to snap them to",
+              path, states.size());
+    }
+
+    usize n = states.size();
+    std::vector<usize> seq(trace.size());
+    for (usize t = 0; t < trace.size(); t++) {
+        usize hi = std::lower_bound(states.begin(), states.end(), trace[t]) -
+                   states.begin();
+        if (hi == n || (hi > 0 && trace[t] - states[hi - 1] <=
+                                      states[hi] - trace[t])) {
+            hi--;
+        }
+        seq[t] = hi;
+    }
+
+    // the trace wraps around, so every visited state has a way out and
+    // state frequencies are exactly stationary for the fitted chain
+    std::vector<double> weights(n * n, 0.0);
+    std::vector<double> visits(n, 0.0);
+    for (usize t = 0; t < seq.size(); t++) {
+        usize next = seq[(t + 1) % seq.size()];
+        weights[seq[t] * n + next] += 1.0;
+        visits[seq[t]] += 1.0;
+    }
+
+    return build(std::move(states), weights, std::move(visits));
+}
+
+double MarkovChain::stay_probability() const {
+    double total = 0.0, p = 0.0;
+    for (usize i = 0; i < stay.size(); i++) {
+        total += stationary[i];
+        p += stationary[i] * stay[i];
+    }
+    return (total > 0.0) ? p / total : 0.0;
+}
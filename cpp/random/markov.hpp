@@ -0,0 +1,60 @@
+#ifndef MARKOV_HPP
+#define MARKOV_HPP
+
+#include "../../c/utils/common.h"
+#include "../../c/utils/list.h"
+
+#include "../utils/common.hpp"
+
+#include "alias.hpp"
+#include "random.hpp"
+
+#include <vector>
+
+/// Markov chain over size classes: the next size depends on the current
+/// one, so runs of one class and switches between classes follow the
+/// transition weights instead of independent draws
+struct MarkovChain {
+    std::vector<Int> sizes;       // size of each state
+    std::vector<AliasTable> rows; // next state by weight, empty = restart
+    AliasTable start;             // stationary distribution
+
+    MarkovChain() = default;
+
+    /// @brief `weights` is the row-major n x n matrix over `sizes`, rows
+    ///        are normalised so counts and probabilities both work
+    static MarkovChain from_matrix(const IntList &sizes,
+                                   const std::vector<double> &weights);
+
+    /// @brief Matrix rows from a file, one line per row
+    static MarkovChain from_file(const IntList &sizes, const char *path);
+
+    /// @brief Count transitions of a recorded size trace (one size per
+    ///        line). Sizes snap to the nearest entry of `sizes`, or become
+    ///        states of their own when `sizes` is empty
+    static MarkovChain from_trace(const IntList &sizes, const char *path);
+
+    bool empty() const { return sizes.empty(); }
+
+    u32 first(Random &rng) const { return start.sample_index(rng); }
+
+    u32 next(u32 state, Random &rng) const {
+        const AliasTable &row = rows[state];
+        return row.empty() ? start.sample_index(rng) : row.sample_index(rng);
+    }
+
+    /// @brief Probability of staying in the same state, averaged over the
+    ///        stationary distribution (mean run length is 1 / (1 - p))
+    double stay_probability() const;
+
+  private:
+    std::vector<double> stay; // per state, for `stay_probability`
+    std::vector<double> stationary;
+
+    /// @brief Empty `stationary` is solved from the matrix
+    static MarkovChain build(std::vector<Int> sizes,
+                             const std::vector<double> &weights,
+                             std::vector<double> stationary);
+};
+
+#endif // MARKOV_HPP
@@ -2,37 +2,87 @@
 
 #include <cmath>
 
-Random::Random(u64 seed) {
-    if (seed == 0) {
-        seed = (u64)time(NULL) ^ (uintptr_t)&seed;
-    }
+// --seed 0 is resolved to the time once by the argument parser, every
+// stream of a run has to come from that one value
+Random::Random(u64 seed, Rng generator) {
     random_state = splitmix64(seed);
     if (random_state == 0) {
         random_state = 0x9e3779b97f4a7c15ULL;
     }
+
+    seed_state = random_state;
+    init_xoshiro(generator);
 }
 
-Int Random::uniform(Int min, Int max) {
-    dbg_assert(min <= max);
+Random Random::split(u64 k) const {
+    return Random(splitmix64(seed_state ^ splitmix64(k)), generator());
+}
+
+Random Random::stream(u64 k) const {
+    Random child = Random(*this);
+    child.random_state = seed_state;
+    if (child.xoshiro != nullptr) {
+        child.xoshiro->lanes.seed(seed_state);
+        child.xoshiro->buffered = Xoshiro8::BLOCK;
+    }
+    for (u64 j = 0; j <= k; j++) {
+        child.jump();
+    }
+    return child;
+}
+
+void Random::jump() {
+    seed_state = splitmix64(seed_state);
+    random_state = (seed_state != 0) ? seed_state : 0x9e3779b97f4a7c15ULL;
+    if (xoshiro != nullptr) {
+        xoshiro->lanes.jump();
+        xoshiro->buffered = Xoshiro8::BLOCK; // drop draws from before the jump
+    }
+}
 
-    Float u = uniform01(); // in [0,1)
-    return min + static_cast<Int>((max - min) * u);
+void Random::set_generator(Rng generator) {
+    if (generator == RNG_XOSHIRO_AVX2 && !Xoshiro8::has_avx2()) {
+        log_warn("CPU has no AVX2, using the portable xoshiro fill");
+        generator = RNG_XOSHIRO;
+    }
+    default_generator = generator;
+}
+
+void XoshiroStream::refill() {
+#if defined(XOSHIRO_HAS_AVX2)
+    if (avx2) {
+        lanes.fill_avx2(buffer);
+        buffered = 0;
+        return;
+    }
+#endif
+    lanes.fill(buffer);
+    buffered = 0;
 }
 
 Int Random::exponential(Int min, Int max, Float lambda) {
+    return exponential_at(uniform01(), min, max, lambda);
+}
+
+Int Random::exponential_at(Float u, Int min, Int max, Float lambda) {
     dbg_assert(min <= max);
     dbg_assert(lambda != 0.0f);
 
-    Float u = uniform01();
-    Float x = -std::log(1.0 - u) / lambda; // in [0, inf)
+    Float x = -std::log(1.0 - u) / lambda; // in [0, inf]
+    if (x >= (Float)max) {
+        return max; // also keeps u == 1 from casting infinity
+    }
 
     return clamp(min, max, static_cast<Int>(x));
 }
 
 Int Random::powerlaw(Int min, Int max, Float alpha) {
+    return powerlaw_at(uniform01(), min, max, alpha);
+}
+
+Int Random::powerlaw_at(Float u, Int min, Int max, Float alpha) {
     dbg_assert(min <= max);
 
-    Float u = uniform01();
     Float x;
     if (std::fabs(alpha - 1.0) < 1e-8) {
         Float ratio = static_cast<Float>(max) / min;
@@ -7,20 +7,119 @@
 
 #include "../utils/common.hpp"
 
+#include "xoshiro.hpp"
+
+#include <memory>
+
+__extension__ typedef unsigned __int128 u128;
+
+/// Outputs of the 8 xoshiro lanes drawn a block at a time, the state
+/// behind `Random` for --rng xoshiro and xoshiro-avx2
+struct XoshiroStream {
+    bool avx2;
+    u32 buffered = Xoshiro8::BLOCK; // next unread entry of `buffer`
+    Xoshiro8 lanes;
+    alignas(32) u64 buffer[Xoshiro8::BLOCK];
+
+    XoshiroStream(u64 seed, bool avx2) : avx2(avx2) { lanes.seed(seed); }
+
+    void refill();
+};
+
 struct Random {
   public:
     u64 random_state;
 
+  private:
+    u64 seed_state; // splitmixed seed, root of `split`
+    // Only allocated and seeded when the generator chosen by
+    // `set_generator` is a xoshiro one, xorshift needs no more than
+    // `random_state`
+    std::unique_ptr<XoshiroStream> xoshiro;
+
+    static inline Rng default_generator = RNG_XORSHIFT;
+
+    Random(u64 seed, Rng generator);
+
+    void init_xoshiro(Rng generator) {
+        if (generator != RNG_XORSHIFT) {
+            xoshiro = std::make_unique<XoshiroStream>(
+                random_state, generator == RNG_XOSHIRO_AVX2);
+        }
+    }
+
   public:
-    Random() : random_state(0x853c49e6748fea9bULL) {}
-    Random(u64 seed);
+    Random() : random_state(0x853c49e6748fea9bULL) {
+        seed_state = random_state;
+        init_xoshiro(default_generator);
+    }
+    Random(u64 seed) : Random(seed, default_generator) {}
+
+    Random(const Random &other)
+        : random_state(other.random_state), seed_state(other.seed_state) {
+        if (other.xoshiro != nullptr) {
+            xoshiro = std::make_unique<XoshiroStream>(*other.xoshiro);
+        }
+    }
+    Random &operator=(const Random &other) {
+        if (this != &other) {
+            *this = Random(other);
+        }
+        return *this;
+    }
+    Random(Random &&) = default;
+    Random &operator=(Random &&) = default;
+
+    /// @brief Independent stream `k` of this generator, derived from its
+    ///        seed through a splitmix64 chain (draws made so far don't
+    ///        matter). Same seed and `k` always give the same stream
+    Random split(u64 k) const;
+
+    /// @brief Worker stream `k` of this generator, for threads, sessions
+    ///        and children of one run. The xoshiro lanes are the seeded
+    ///        ones jumped k + 1 times by 2^128 draws, so worker streams
+    ///        never overlap; xorshift restarts from link k + 1 of a
+    ///        splitmix64 chain. Draws made so far don't matter
+    Random stream(u64 k) const;
+
+    /// @brief Move on to the next worker stream: `stream(k)` followed by
+    ///        `jump()` draws like `stream(k + 1)`. Far cheaper than
+    ///        `stream(k + 1)` for large k, which jumps k + 2 times
+    void jump();
+
+    /// @brief Generator of every Random constructed afterwards. The AVX2
+    ///        variant falls back to the portable xoshiro fill (same
+    ///        numbers) on CPUs without AVX2
+    static void set_generator(Rng generator);
 
     bool coin_flip(void) { return (uniform(0, 2) % 2) == 1; }
 
-    Int uniform(Int min, Int max);
+    /// @brief Generator this instance draws from
+    Rng generator() const {
+        if (xoshiro == nullptr) {
+            return RNG_XORSHIFT;
+        }
+        return xoshiro->avx2 ? RNG_XOSHIRO_AVX2 : RNG_XOSHIRO;
+    }
+
+    Int uniform(Int min, Int max) {
+        dbg_assert(min <= max);
+
+        if (xoshiro != nullptr) {
+            return min + (Int)bounded(max - min);
+        }
+
+        Float u = uniform01(); // in [0,1)
+        return min + static_cast<Int>((max - min) * u);
+    }
     Int exponential(Int min, Int max, Float lambda);
     Int powerlaw(Int min, Int max, Float alpha);
 
+    /// @brief Same distributions at a given quantile `u` in [0, 1], for
+    ///        callers that correlate draws
+    static Int exponential_at(Float u, Int min, Int max, Float lambda);
+    static Int powerlaw_at(Float u, Int min, Int max, Float alpha);
+
     Int next(Int min, Int max, Float param, Distribution distribution);
 
     Int choice(const IntList &l);
@@ -38,12 +137,41 @@ struct Random {
     }
 
     double uniform01(void) {
-        u64 r = xs64star() >> 11;
+        u64 r = next_u64() >> 11;
         return (double)r * (1.0 / (double)(1ULL << 53));
     }
 
-  private:
+    /// @brief Raw 64 bits, from the buffer for the xoshiro generators
+    u64 next_u64(void) {
+        if (xoshiro == nullptr) {
+            return xs64star();
+        }
+        if (xoshiro->buffered == Xoshiro8::BLOCK) {
+            xoshiro->refill();
+        }
+        return xoshiro->buffer[xoshiro->buffered++];
+    }
+
+    /// @brief Uniform integer in [0, range) with Lemire's multiply-shift,
+    ///        unbiased, one 64-bit multiply and almost never a division
+    u64 bounded(u64 range) {
+        if (range == 0) {
+            return 0;
+        }
 
+        u128 m = (u128)next_u64() * range;
+        u64 low = (u64)m;
+        if (low < range) {
+            u64 threshold = -range % range;
+            while (low < threshold) {
+                m = (u128)next_u64() * range;
+                low = (u64)m;
+            }
+        }
+        return (u64)(m >> 64);
+    }
+
+  private:
     u64 splitmix64(u64 x) const {
         uint64_t z = x + 0x9e3779b97f4a7c15ULL;
         z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
@@ -0,0 +1,156 @@
+#include "xoshiro.hpp"
+
+#if defined(XOSHIRO_HAS_AVX2)
+#include <immintrin.h>
+#endif
+
+static inline u64 rotl(u64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+// Jump polynomials of the reference xoshiro256 implementation
+static constexpr u64 JUMP[4] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+static constexpr u64 LONG_JUMP[4] = {
+    0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL,
+    0x39109bb02acbe635ULL};
+
+static inline void advance(u64 st[4]) {
+    u64 t = st[1] << 17;
+    st[2] ^= st[0];
+    st[3] ^= st[1];
+    st[1] ^= st[2];
+    st[0] ^= st[3];
+    st[2] ^= t;
+    st[3] = rotl(st[3], 45);
+}
+
+/// @brief Advance one stream by the distance encoded in `poly`
+static void jump_lane(u64 st[4], const u64 poly[4]) {
+    u64 acc[4] = {0, 0, 0, 0};
+    for (usize i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (poly[i] & (1ULL << b)) {
+                for (usize w = 0; w < 4; w++) {
+                    acc[w] ^= st[w];
+                }
+            }
+            advance(st);
+        }
+    }
+    for (usize w = 0; w < 4; w++) {
+        st[w] = acc[w];
+    }
+}
+
+void Xoshiro8::seed(u64 seed) {
+    u64 st[4];
+    u64 z = seed;
+    for (usize w = 0; w < 4; w++) {
+        z += 0x9e3779b97f4a7c15ULL;
+        u64 x = z;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        st[w] = x ^ (x >> 31);
+    }
+
+    // all-zero is the one state xoshiro never leaves
+    if ((st[0] | st[1] | st[2] | st[3]) == 0) {
+        st[0] = 1;
+    }
+
+    for (usize l = 0; l < LANES; l++) {
+        if (l > 0) {
+            jump_lane(st, LONG_JUMP);
+        }
+        for (usize w = 0; w < 4; w++) {
+            s[w][l] = st[w];
+        }
+    }
+}
+
+void Xoshiro8::jump() {
+    for (usize l = 0; l < LANES; l++) {
+        u64 st[4] = {s[0][l], s[1][l], s[2][l], s[3][l]};
+        jump_lane(st, JUMP);
+        for (usize w = 0; w < 4; w++) {
+            s[w][l] = st[w];
+        }
+    }
+}
+
+void Xoshiro8::fill(u64 *out) {
+    for (usize step = 0; step < STEPS; step++) {
+        for (usize l = 0; l < LANES; l++) {
+            out[step * LANES + l] = rotl(s[1][l] * 5, 7) * 9;
+
+            u64 t = s[1][l] << 17;
+            s[2][l] ^= s[0][l];
+            s[3][l] ^= s[1][l];
+            s[1][l] ^= s[2][l];
+            s[0][l] ^= s[3][l];
+            s[2][l] ^= t;
+            s[3][l] = rotl(s[3][l], 45);
+        }
+    }
+}
+
+#if defined(XOSHIRO_HAS_AVX2)
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static inline __m256i rotl4(__m256i x, int k) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, k),
+                           _mm256_srli_epi64(x, 64 - k));
+}
+
+// AVX2 has no 64-bit multiply, `* 5` and `* 9` become shift and add
+AVX2 static inline __m256i mul5(__m256i x) {
+    return _mm256_add_epi64(_mm256_slli_epi64(x, 2), x);
+}
+
+AVX2 static inline __m256i mul9(__m256i x) {
+    return _mm256_add_epi64(_mm256_slli_epi64(x, 3), x);
+}
+
+AVX2 void Xoshiro8::fill_avx2(u64 *out) {
+    static_assert(LANES == 8, "two 4-lane registers per state word");
+
+    __m256i s0[2], s1[2], s2[2], s3[2];
+    for (usize h = 0; h < 2; h++) {
+        s0[h] = _mm256_load_si256((const __m256i *)&s[0][h * 4]);
+        s1[h] = _mm256_load_si256((const __m256i *)&s[1][h * 4]);
+        s2[h] = _mm256_load_si256((const __m256i *)&s[2][h * 4]);
+        s3[h] = _mm256_load_si256((const __m256i *)&s[3][h * 4]);
+    }
+
+    for (usize step = 0; step < STEPS; step++) {
+        for (usize h = 0; h < 2; h++) {
+            __m256i r = mul9(rotl4(mul5(s1[h]), 7));
+            _mm256_storeu_si256((__m256i *)&out[step * LANES + h * 4], r);
+
+            __m256i t = _mm256_slli_epi64(s1[h], 17);
+            s2[h] = _mm256_xor_si256(s2[h], s0[h]);
+            s3[h] = _mm256_xor_si256(s3[h], s1[h]);
+            s1[h] = _mm256_xor_si256(s1[h], s2[h]);
+            s0[h] = _mm256_xor_si256(s0[h], s3[h]);
+            s2[h] = _mm256_xor_si256(s2[h], t);
+            s3[h] = rotl4(s3[h], 45);
+        }
+    }
+
+    for (usize h = 0; h < 2; h++) {
+        _mm256_store_si256((__m256i *)&s[0][h * 4], s0[h]);
+        _mm256_store_si256((__m256i *)&s[1][h * 4], s1[h]);
+        _mm256_store_si256((__m256i *)&s[2][h * 4], s2[h]);
+        _mm256_store_si256((__m256i *)&s[3][h * 4], s3[h]);
+    }
+}
+
+#undef AVX2
+
+bool Xoshiro8::has_avx2() { return __builtin_cpu_supports("avx2"); }
+
+#else
+
+bool Xoshiro8::has_avx2() { return false; }
+
+#endif // XOSHIRO_HAS_AVX2
@@ -0,0 +1,41 @@
+#ifndef XOSHIRO_HPP
+#define XOSHIRO_HPP
+
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define XOSHIRO_HAS_AVX2 1
+#endif
+
+/// 8 independent xoshiro256** streams kept side by side (lane-major per
+/// state word), so one step of all lanes is a handful of vector ops. The
+/// portable and AVX2 fills produce the same outputs bit for bit
+struct Xoshiro8 {
+    static constexpr usize LANES = 8;
+    static constexpr usize STEPS = 8;
+    static constexpr usize BLOCK = LANES * STEPS; // outputs per fill
+
+    alignas(32) u64 s[4][LANES];
+
+    /// @brief Seed lane 0 from a splitmix64 chain, every further lane is
+    ///        the previous one advanced by 2^192 steps (long jump), so no
+    ///        two lanes can overlap
+    void seed(u64 seed);
+
+    /// @brief Advance every lane by 2^128 steps
+    void jump();
+
+    /// @brief Write BLOCK outputs, step-major: out[step * LANES + lane]
+    void fill(u64 *out);
+
+#if defined(XOSHIRO_HAS_AVX2)
+    void fill_avx2(u64 *out);
+#endif
+
+    /// @brief Can `fill_avx2` run on this CPU
+    static bool has_avx2();
+};
+
+#endif // XOSHIRO_HPP
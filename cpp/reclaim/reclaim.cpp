@@ -0,0 +1,230 @@
+#include "reclaim.hpp"
+
+#include "../concurrent/ring.hpp"
+
+#include <chrono>
+#include <iomanip>
+#include <thread>
+#include <vector>
+
+namespace reclaim {
+
+static constexpr usize QUEUE_CAPACITY = 1 << 16;
+static constexpr usize BATCH = 256;
+
+/// Block waiting for the reclaimer
+struct Retired {
+    Block block;
+    u64 retired_ns = 0;
+};
+
+// Same fields as `Stats`, updated from any worker thread. Only thread and
+// epoch mode count, all with relaxed updates
+struct AtomicStats {
+    std::atomic<usize> retire_calls{0};
+    std::atomic<usize> retire_time_ns{0};
+    std::atomic<usize> retire_time_max_ns{0};
+    std::atomic<usize> retired_bytes{0};
+    std::atomic<usize> retired_bytes_peak{0};
+    std::atomic<usize> reclaim_batches{0};
+    std::atomic<usize> queue_max{0};
+    std::atomic<usize> lag_max_ns{0};
+    std::atomic<usize> overflows{0};
+    std::atomic<usize> limit_flushes{0};
+    std::atomic<usize> flush_time_ns{0};
+
+    Stats load() const {
+        Stats s;
+        s.retire_calls = retire_calls;
+        s.retire_time_ns = retire_time_ns;
+        s.retire_time_max_ns = retire_time_max_ns;
+        s.retired_bytes = retired_bytes;
+        s.retired_bytes_peak = retired_bytes_peak;
+        s.reclaim_batches = reclaim_batches;
+        s.queue_max = queue_max;
+        s.lag_max_ns = lag_max_ns;
+        s.overflows = overflows;
+        s.limit_flushes = limit_flushes;
+        s.flush_time_ns = flush_time_ns;
+        return s;
+    }
+};
+
+static AtomicStats counters;
+
+static Reclaim mode = RECLAIM_IMMEDIATE;
+static std::unique_ptr<concurrent::MpscRing<Retired>> queue;
+static std::thread reclaimer;
+static std::atomic<bool> stopping{false};
+static usize epoch_length = 0;
+static usize retire_limit = 0;
+
+static inline u64 now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static inline void store_max(std::atomic<usize> &max, usize value) {
+    usize cur = max.load(std::memory_order_relaxed);
+    while (value > cur &&
+           !max.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {
+    }
+}
+
+Stats stats() { return counters.load(); }
+
+static void add_retired(usize bytes) {
+    usize now =
+        counters.retired_bytes.fetch_add(bytes, std::memory_order_relaxed) +
+        bytes;
+    store_max(counters.retired_bytes_peak, now);
+}
+
+/// Blocks a thread retired in the current epoch, freed together
+struct RetireList {
+    std::vector<Retired> items;
+    usize bytes = 0;
+
+    void flush(bool over_limit) {
+        if (self.items.empty()) {
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        u64 now = now_ns();
+        store_max(counters.lag_max_ns, now - self.items.front().retired_ns);
+        self.items.clear();
+
+        counters.retired_bytes.fetch_sub(self.bytes, std::memory_order_relaxed);
+        self.bytes = 0;
+        counters.reclaim_batches.fetch_add(1, std::memory_order_relaxed);
+        if (over_limit) {
+            counters.limit_flushes.fetch_add(1, std::memory_order_relaxed);
+        }
+        counters.flush_time_ns.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start)
+                .count(),
+            std::memory_order_relaxed);
+    }
+
+    // worker threads free their last epoch when they exit
+    ~RetireList() { self.flush(false); }
+};
+
+static thread_local RetireList retire_list;
+
+static void reclaimer_loop() {
+    Retired item;
+    while (true) {
+        store_max(counters.queue_max, queue->size());
+
+        usize n = 0;
+        while (n < BATCH && queue->try_pop(item)) {
+            usize size = item.block.size;
+            item.block = Block();
+            counters.retired_bytes.fetch_sub(size, std::memory_order_relaxed);
+            store_max(counters.lag_max_ns, now_ns() - item.retired_ns);
+            n++;
+        }
+
+        if (n > 0) {
+            counters.reclaim_batches.fetch_add(1, std::memory_order_relaxed);
+        } else if (stopping.load(std::memory_order_acquire)) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+}
+
+void init(const Args &args) {
+    mode = (Reclaim)args.reclaim.as.e;
+    if (mode == RECLAIM_THREAD) {
+        queue = std::make_unique<concurrent::MpscRing<Retired>>(QUEUE_CAPACITY);
+        stopping.store(false, std::memory_order_relaxed);
+        reclaimer = std::thread(reclaimer_loop);
+    }
+
+    epoch_length = args.epoch_length.as.i;
+    retire_limit = args.retire_limit.as.i;
+}
+
+void retire(Block &&block) {
+    // the default path of every free, destroyed right here with no timing
+    // and no shared counters
+    if (mode == RECLAIM_IMMEDIATE) {
+        Block victim = std::move(block);
+        return;
+    }
+
+    if (block.data == nullptr) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    usize size = block.size;
+
+    switch (mode) {
+    case RECLAIM_THREAD: {
+        Retired item = {std::move(block), now_ns()};
+        if (queue->try_push(item)) {
+            add_retired(size);
+        } else {
+            // `item` is destroyed here
+            counters.overflows.fetch_add(1, std::memory_order_relaxed);
+        }
+    } break;
+    case RECLAIM_EPOCH: {
+        retire_list.items.push_back({std::move(block), now_ns()});
+        retire_list.bytes += size;
+        add_retired(size);
+        if (retire_limit > 0 && retire_list.bytes >= retire_limit) {
+            retire_list.flush(true);
+        }
+    } break;
+    default:
+        panic("Unknown reclaim mode %u", mode);
+    }
+
+    usize elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    counters.retire_calls.fetch_add(1, std::memory_order_relaxed);
+    counters.retire_time_ns.fetch_add(elapsed, std::memory_order_relaxed);
+    store_max(counters.retire_time_max_ns, elapsed);
+}
+
+void tick(usize iteration) {
+    if (mode == RECLAIM_EPOCH && epoch_length > 0 &&
+        (iteration % epoch_length) == 0) {
+        retire_list.flush(false);
+    }
+}
+
+void shutdown() {
+    retire_list.flush(false);
+    if (mode == RECLAIM_THREAD && reclaimer.joinable()) {
+        stopping.store(true, std::memory_order_release);
+        reclaimer.join();
+    }
+}
+
+void print_report() {
+    Stats s = stats();
+    double calls = (s.retire_calls > 0) ? (double)s.retire_calls : 1.0;
+
+    std::cout << std::fixed << std::setprecision(1) << "reclaim "
+              << reclaims[mode] << ": " << s.retire_calls
+              << " retired, worker avg " << s.retire_time_ns / calls
+              << " ns max " << s.retire_time_max_ns << " ns, "
+              << s.reclaim_batches << " batches, queue max " << s.queue_max
+              << ", lag max " << s.lag_max_ns / 1e3
+              << " us, retired peak " << s.retired_bytes_peak << " B, "
+              << s.overflows << " overflows, " << s.limit_flushes
+              << " limit flushes, " << s.flush_time_ns / 1e6
+              << " ms flushing\n";
+}
+
+} // namespace reclaim
@@ -0,0 +1,32 @@
+#ifndef RECLAIM_HPP
+#define RECLAIM_HPP
+
+#include "../../c/utils/args_parser.h"
+#include "../../c/utils/common.h"
+
+#include "../pool/pool.hpp"
+#include "stats.hpp"
+
+namespace reclaim {
+
+/// @brief Configure reclamation from arguments, starts the reclaimer
+///        thread for RECLAIM_THREAD
+void init(const Args &args);
+
+/// @brief Take a block a pool just evicted. Destroys it right away or
+///        defers it, depending on the mode
+void retire(Block &&block);
+
+/// @brief Per iteration hook, frees the calling thread's retire list at
+///        epoch boundaries (RECLAIM_EPOCH)
+void tick(usize iteration);
+
+/// @brief Destroy everything still deferred and stop background threads
+void shutdown();
+
+/// @brief One line summary of the deferred reclamation
+void print_report();
+
+} // namespace reclaim
+
+#endif // RECLAIM_HPP
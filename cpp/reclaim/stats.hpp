@@ -0,0 +1,28 @@
+#ifndef RECLAIM_STATS_HPP
+#define RECLAIM_STATS_HPP
+
+#include "../../c/utils/common.h"
+
+namespace reclaim {
+
+/// Reclamation counters, exported with every tracker snapshot. Kept apart
+/// from `reclaim.hpp` so the tracker does not depend on `Block`
+struct Stats {
+    usize retire_calls = 0;       // blocks handed over by pools
+    usize retire_time_ns = 0;     // worker time spent handing them over
+    usize retire_time_max_ns = 0; // slowest single hand-over
+    usize retired_bytes = 0;      // retired, not destroyed yet
+    usize retired_bytes_peak = 0;
+    usize reclaim_batches = 0;    // batches destroyed off the worker
+    usize queue_max = 0;          // deepest reclaimer queue seen
+    usize lag_max_ns = 0;         // longest retire to destroy delay
+    usize overflows = 0;          // queue full, destroyed on the worker
+    usize limit_flushes = 0;      // epoch lists freed early, over the limit
+    usize flush_time_ns = 0;      // worker time spent freeing epoch lists
+};
+
+Stats stats();
+
+} // namespace reclaim
+
+#endif // RECLAIM_STATS_HPP
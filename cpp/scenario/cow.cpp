@@ -0,0 +1,118 @@
+#include "scenario.hpp"
+
+#include "../actions/actions.hpp"
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+#include "../reclaim/reclaim.hpp"
+#include "../tracker/tracker.hpp"
+
+#include <cstring>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace scenario {
+
+/// @brief Write one byte in every page of the block, each write to a page
+///        still shared with the parent takes a copy-on-write fault
+static void touch(Block &block, usize page) {
+    for (usize off = 0; off < block.size; off += page) {
+        block.data[off]++;
+    }
+}
+
+/// @brief Child works on its copy of the parent's pool. Tracker counters
+///        are inherited too, so current size starts at the parent's fill
+[[noreturn]] static void cow_child(const Args &args, usize k, Pool &pool,
+                                   ProcessSlot &slot) {
+    usize page = (usize)sysconf(_SC_PAGESIZE);
+    Random rng = Random(args.seed.as.i).stream(k);
+    action::init_actions(args);
+
+    publish(slot); // baseline right after fork
+
+    child_loop(args, k, slot, [&]() {
+        if (pool.count() > 0 && rng.uniform01() < args.touch_freq.as.f) {
+            touch(pool[rng.uniform(0, pool.count())], page);
+        } else {
+            action::block_action(pool, args, rng);
+        }
+    });
+
+    reclaim::shutdown();
+    slot.finished.store(true, std::memory_order_release);
+    _exit(0); // inherited blocks go away with the address space
+}
+
+void run_cow(const Args &args, std::ofstream &output) {
+    usize processes = args.processes.as.i;
+    ProcessSlot *slots = map_process_slots(processes);
+
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+    tracker.init();
+    tracker.setSampleOnAlloc(false);
+
+    Pool pool = Pool(std::max<usize>(args.capacity.as.i, 1));
+    {
+        Random rng = Random(args.seed.as.i);
+        while (pool.count() < pool.capacity) {
+            Int size = action::get_block_size(args, rng);
+            SInt ttl = action::get_block_ttl(args, rng, size);
+            pool.add_block(size, ttl);
+        }
+    }
+
+    tracker.merge();
+    usize filled = tracker.currentSizeAllocated();
+    tracker::ProcessStats parent;
+    parent.readFromProc();
+
+    // anything buffered now would be printed once per child
+    std::cout.flush();
+    fflush(stdout);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<pid_t> pids(processes, 0);
+    for (usize k = 0; k < processes; k++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            panic("fork failed: %s", strerror(errno));
+        }
+        if (pid == 0) {
+            cow_child(args, k, pool, slots[k]);
+        }
+        pids[k] = pid;
+    }
+
+    monitor_processes(args, slots, pids, output);
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+
+    std::vector<WorkerState> workers(processes);
+    for (usize k = 0; k < processes; k++) {
+        workers[k].role = "process";
+        workers[k].ops.store(slots[k].ops.load(std::memory_order_relaxed));
+        workers[k].seconds = slots[k].elapsed_us.load() / 1e6;
+    }
+    print_report("cow", workers, seconds);
+
+    std::cout << "  parent: " << pool.count() << " blocks, " << filled
+              << " B allocated, pss " << parent.pssBytes()
+              << " B, private dirty " << parent.privateDirtyBytes()
+              << " B before fork\n";
+    for (usize k = 0; k < processes; k++) {
+        const ProcessSlot &s = slots[k];
+        std::cout << "  process " << k << ": "
+                  << s.minor_faults.load(std::memory_order_relaxed)
+                  << " minor faults, private dirty "
+                  << s.private_dirty.load(std::memory_order_relaxed)
+                  << " B, pss " << s.pss.load(std::memory_order_relaxed)
+                  << " B\n";
+    }
+
+    unmap_process_slots(slots, processes);
+}
+
+} // namespace scenario
@@ -0,0 +1,276 @@
+#include "handoff_stats.hpp"
+#include "scenario.hpp"
+
+#include "../actions/actions.hpp"
+#include "../backend/backend.hpp"
+#include "../concurrent/ring.hpp"
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+#include "../reclaim/reclaim.hpp"
+
+#include <barrier>
+#include <deque>
+#include <iomanip>
+#include <thread>
+
+namespace scenario {
+
+/// Block in flight between a producer and a consumer
+struct Handoff {
+    Block block;
+    u64 sent_ns = 0;
+};
+
+using Ring = concurrent::MpscRing<Handoff>;
+
+/// Consumer side counters, only written by the owning consumer and read
+/// by tracker snapshots
+struct alignas(64) ConsumerStats {
+    std::atomic<usize> received{0};
+    std::atomic<usize> dropped{0}; // pool full and policy could not free
+    std::atomic<usize> latency_sum_ns{0};
+    std::atomic<usize> latency_max_ns{0};
+    std::atomic<usize> depth_sum{0};
+    std::atomic<usize> depth_max{0};
+};
+
+/// Producer side counters, only written by the owning producer and read
+/// by tracker snapshots
+struct alignas(64) ProducerStats {
+    std::atomic<usize> sent{0};
+    std::atomic<usize> full_waits{0}; // pushes that found the ring full
+};
+
+// Outlive `run_handoff` so the final snapshot still sees them, a deque
+// because the atomics can't be moved
+static std::deque<ProducerStats> producer_stats;
+static std::deque<ConsumerStats> consumer_stats;
+
+/// @brief Add to a counter nobody else writes, without a locked RMW
+static inline void bump(std::atomic<usize> &counter, usize delta) {
+    counter.store(counter.load(std::memory_order_relaxed) + delta,
+                  std::memory_order_relaxed);
+}
+
+static inline void raise(std::atomic<usize> &max, usize value) {
+    if (value > max.load(std::memory_order_relaxed)) {
+        max.store(value, std::memory_order_relaxed);
+    }
+}
+
+HandoffStats handoff_stats() {
+    HandoffStats s;
+    for (const ProducerStats &p : producer_stats) {
+        s.sent += p.sent.load(std::memory_order_relaxed);
+        s.full_waits += p.full_waits.load(std::memory_order_relaxed);
+    }
+    for (const ConsumerStats &c : consumer_stats) {
+        s.received += c.received.load(std::memory_order_relaxed);
+        s.dropped += c.dropped.load(std::memory_order_relaxed);
+        s.latency_sum_ns += c.latency_sum_ns.load(std::memory_order_relaxed);
+        s.latency_max_ns = std::max(
+            s.latency_max_ns, c.latency_max_ns.load(std::memory_order_relaxed));
+        s.depth_sum += c.depth_sum.load(std::memory_order_relaxed);
+        s.depth_max =
+            std::max(s.depth_max, c.depth_max.load(std::memory_order_relaxed));
+    }
+    return s;
+}
+
+static void producer(const Args &args, usize k, usize producers,
+                     std::vector<std::unique_ptr<Ring>> &rings,
+                     std::barrier<> &start, std::atomic<bool> &stop,
+                     std::atomic<usize> &done, WorkerState &state,
+                     ProducerStats &stats) {
+    bool timed = args.duration_sec.as.i > 0;
+    usize iterations = split_work(args.iterations.as.i, producers, k);
+
+    Random rng = Random(args.seed.as.i).stream(k);
+    action::init_actions(args);
+
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+
+    usize i = 0;
+    usize target = k % rings.size();
+    while (timed ? !stop.load(std::memory_order_relaxed) : i < iterations) {
+        Int size = action::get_block_size(args, rng);
+        SInt ttl = action::get_block_ttl(args, rng, size);
+        Handoff item = {Block(size, ttl), 0};
+
+        Ring &ring = *rings[target];
+        item.sent_ns = now_ns();
+        if (!ring.try_push(item)) {
+            bump(stats.full_waits, 1);
+            do {
+                std::this_thread::yield();
+                item.sent_ns = now_ns();
+            } while (!ring.try_push(item));
+        }
+        bump(stats.sent, 1);
+        target = (target + 1) % rings.size();
+
+        i++;
+        backend::maintain(i);
+        state.ops.store(i, std::memory_order_relaxed);
+    }
+
+    state.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count();
+    done.fetch_add(1, std::memory_order_release);
+    state.finished.store(true, std::memory_order_release);
+}
+
+/// @brief Adopt received block into the local pool, freeing by policy to
+///        make room. Mirrors the alloc/free ratio of the single loop.
+///        Returns the number of blocks freed, a dropped one included
+static usize adopt(Pool &pool, const Args &args, Random &rng, Block &&block,
+                   ConsumerStats &stats) {
+    usize before = pool.count();
+    if (args.ttl_mode.as.e != TTL_OFF) {
+        pool.update_and_prune();
+    }
+
+    Policy policy = (Policy)args.policy.as.e;
+    if (pool.count() > 0 && rng.uniform01() >= args.alloc_freq.as.f) {
+        pool.del_block(policy, rng);
+    }
+    if (pool.count() >= pool.capacity) {
+        pool.del_block(policy, rng);
+    }
+
+    if (pool.count() >= pool.capacity) {
+        bump(stats.dropped, 1);
+        return before + 1 - pool.count(); // `block` is released here
+    }
+    pool.add_block(std::move(block));
+    return before + 1 - pool.count();
+}
+
+static void consumer(const Args &args, usize k, usize consumers,
+                     usize producers, Ring &ring, std::barrier<> &start,
+                     std::atomic<usize> &done, WorkerState &state,
+                     ConsumerStats &stats) {
+    usize capacity = split_work(args.capacity.as.i, consumers, k);
+    Random rng = Random(args.seed.as.i).stream(producers + k);
+
+    {
+        Pool pool = Pool(std::max<usize>(capacity, 1));
+
+        start.arrive_and_wait();
+        auto begin = std::chrono::steady_clock::now();
+
+        Handoff item;
+        usize received = 0;
+        usize ops = 0; // blocks received and blocks freed
+        while (true) {
+            usize depth = ring.size();
+            if (!ring.try_pop(item)) {
+                if (done.load(std::memory_order_acquire) < producers) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // producers are gone, one last pop catches late pushes
+                if (!ring.try_pop(item)) {
+                    break;
+                }
+            }
+
+            u64 latency = now_ns() - item.sent_ns;
+            received++;
+            bump(stats.received, 1);
+            bump(stats.latency_sum_ns, latency);
+            raise(stats.latency_max_ns, latency);
+            bump(stats.depth_sum, depth);
+            raise(stats.depth_max, depth);
+
+            ops += 1 + adopt(pool, args, rng, std::move(item.block), stats);
+            item = Handoff{};
+            reclaim::tick(received);
+            state.ops.store(ops, std::memory_order_relaxed);
+        }
+
+        state.seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - begin)
+                            .count();
+    }
+
+    state.finished.store(true, std::memory_order_release);
+}
+
+// Consumers are labelled by worker index like in `print_report`
+static void print_handoff(usize producers) {
+    std::cout << "  ring full waits: " << handoff_stats().full_waits << "\n";
+
+    for (usize k = 0; k < consumer_stats.size(); k++) {
+        const ConsumerStats &c = consumer_stats[k];
+        usize received = c.received.load(std::memory_order_relaxed);
+        double n = (received > 0) ? (double)received : 1.0;
+        std::cout << std::fixed << std::setprecision(1) << "  consumer "
+                  << producers + k << ": " << received << " received, "
+                  << c.dropped << " dropped, latency avg "
+                  << c.latency_sum_ns / n / 1e3 << " us max "
+                  << c.latency_max_ns / 1e3 << " us, depth avg "
+                  << c.depth_sum / n << " max " << c.depth_max << "\n";
+    }
+}
+
+void run_handoff(const Args &args, std::ofstream &output) {
+    usize threads = args.threads.as.i;
+    usize producers =
+        (args.producers.as.i > 0) ? args.producers.as.i : threads / 2;
+    usize consumers = threads - producers;
+
+    std::vector<std::unique_ptr<Ring>> rings;
+    for (usize k = 0; k < consumers; k++) {
+        rings.push_back(std::make_unique<Ring>(args.ring_size.as.i));
+    }
+
+    std::vector<WorkerState> workers(threads);
+    producer_stats.clear();
+    consumer_stats.clear();
+    for (usize k = 0; k < producers; k++) {
+        producer_stats.emplace_back();
+    }
+    for (usize k = 0; k < consumers; k++) {
+        consumer_stats.emplace_back();
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<usize> done{0};
+    std::barrier<> start((std::ptrdiff_t)threads + 1);
+
+    std::vector<std::thread> handles;
+    for (usize k = 0; k < producers; k++) {
+        workers[k].role = "producer";
+        handles.emplace_back(producer, std::cref(args), k, producers,
+                             std::ref(rings), std::ref(start), std::ref(stop),
+                             std::ref(done), std::ref(workers[k]),
+                             std::ref(producer_stats[k]));
+    }
+    for (usize k = 0; k < consumers; k++) {
+        WorkerState &state = workers[producers + k];
+        state.role = "consumer";
+        state.paced = false; // --iterations counts produced blocks
+        handles.emplace_back(consumer, std::cref(args), k, consumers,
+                             producers, std::ref(*rings[k]), std::ref(start),
+                             std::ref(done), std::ref(state),
+                             std::ref(consumer_stats[k]));
+    }
+
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+
+    monitor(args, workers, stop, output);
+    for (std::thread &t : handles) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    print_report("handoff", workers, seconds);
+    print_handoff(producers);
+}
+
+} // namespace scenario
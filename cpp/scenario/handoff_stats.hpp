@@ -0,0 +1,27 @@
+#ifndef HANDOFF_STATS_HPP
+#define HANDOFF_STATS_HPP
+
+#include "../../c/utils/common.h"
+
+namespace scenario {
+
+/// Handoff scenario counters summed over all producers and consumers,
+/// exported with every tracker snapshot. Kept apart from `scenario.hpp`
+/// so the tracker does not depend on the rings. All zero in other
+/// scenarios
+struct HandoffStats {
+    usize sent = 0;
+    usize received = 0;
+    usize full_waits = 0;     // pushes that found the ring full
+    usize dropped = 0;        // pool full and policy could not free anything
+    usize latency_sum_ns = 0; // push to pop, over all received blocks
+    usize latency_max_ns = 0;
+    usize depth_sum = 0; // ring depth seen by every pop
+    usize depth_max = 0;
+};
+
+HandoffStats handoff_stats();
+
+} // namespace scenario
+
+#endif // HANDOFF_STATS_HPP
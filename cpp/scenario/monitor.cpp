@@ -0,0 +1,79 @@
+#include "scenario.hpp"
+
+#include "../tracker/tracker.hpp"
+
+#include <iomanip>
+#include <thread>
+
+namespace scenario {
+
+usize split_work(usize total, usize workers, usize k) {
+    dbg_assert(workers > 0);
+    return total / workers + ((k < total % workers) ? 1 : 0);
+}
+
+void monitor(const Args &args, std::vector<WorkerState> &workers,
+             std::atomic<bool> &stop, std::ofstream &output) {
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+
+    bool timed = args.duration_sec.as.i > 0;
+    utils::ProgressBar progress =
+        utils::ProgressBar::from_iterations(args.iterations.as.i);
+    if (timed) {
+        progress = utils::ProgressBar::from_duration(args.duration_sec.as.i);
+    }
+    progress.display(args.display.as.b);
+
+    Int interval = (args.snap_interval.as.i > 0) ? args.snap_interval.as.i : 1;
+    usize next_snap = interval;
+    while (true) {
+        usize total = 0;
+        usize finished = 0;
+        for (WorkerState &w : workers) {
+            if (w.paced) {
+                total += w.ops.load(std::memory_order_relaxed);
+            }
+            finished += w.finished.load(std::memory_order_acquire) ? 1 : 0;
+        }
+
+        progress.update_to(total);
+        if (output.is_open() && total >= next_snap) {
+            tracker.write(output);
+            next_snap = (total / interval + 1) * interval;
+        }
+
+        if (finished == workers.size()) {
+            break;
+        }
+        if (timed && progress.is_finished()) {
+            stop.store(true, std::memory_order_relaxed);
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    progress.finish();
+}
+
+void print_report(const char *name, const std::vector<WorkerState> &workers,
+                  double seconds) {
+    usize total = 0;
+    for (const WorkerState &w : workers) {
+        total += w.ops.load(std::memory_order_relaxed);
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << name << ": "
+              << workers.size() << " workers, " << total << " ops in "
+              << seconds << " s, "
+              << ((seconds > 0.0) ? total / seconds : 0.0) << " ops/s\n";
+
+    for (usize k = 0; k < workers.size(); k++) {
+        const WorkerState &w = workers[k];
+        usize ops = w.ops.load(std::memory_order_relaxed);
+        std::cout << "  " << w.role << " " << k << ": " << ops << " ops, "
+                  << ((w.seconds > 0.0) ? ops / w.seconds : 0.0)
+                  << " ops/s\n";
+    }
+}
+
+} // namespace scenario
@@ -0,0 +1,280 @@
+#include "scenario.hpp"
+
+#include "../actions/actions.hpp"
+#include "../backend/backend.hpp"
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+#include "../reclaim/reclaim.hpp"
+#include "../tracker/tracker.hpp"
+
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace scenario {
+
+ProcessSlot *map_process_slots(usize count) {
+    void *p = mmap(nullptr, count * sizeof(ProcessSlot), PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        panic("Could not map shared statistics: %s", strerror(errno));
+    }
+
+    ProcessSlot *slots = (ProcessSlot *)p;
+    for (usize k = 0; k < count; k++) {
+        new (&slots[k]) ProcessSlot();
+    }
+    return slots;
+}
+
+void unmap_process_slots(ProcessSlot *slots, usize count) {
+    for (usize k = 0; k < count; k++) {
+        slots[k].~ProcessSlot();
+    }
+    munmap(slots, count * sizeof(ProcessSlot));
+}
+
+void publish(ProcessSlot &slot) {
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+    tracker.merge();
+
+    tracker::SystemMemoryStats system;
+    tracker::ProcessStats process;
+    system.readFromProc();
+    process.readFromProc();
+
+    slot.current_size.store(tracker.currentSizeAllocated(),
+                            std::memory_order_relaxed);
+    slot.peak_size.store(tracker.peakSizeAllocated(), std::memory_order_relaxed);
+    slot.total_size.store(tracker.totalSizeAllocated(),
+                          std::memory_order_relaxed);
+    slot.allocations.store(tracker.totalNumberOfAllocations(),
+                           std::memory_order_relaxed);
+    slot.freed.store(tracker.freedAllocationSize(), std::memory_order_relaxed);
+
+    slot.rss.store(system.vmRssBytes(), std::memory_order_relaxed);
+    slot.pss.store(process.pssBytes(), std::memory_order_relaxed);
+    slot.private_dirty.store(process.privateDirtyBytes(),
+                             std::memory_order_relaxed);
+    slot.minor_faults.store(process.minor_faults, std::memory_order_relaxed);
+    slot.major_faults.store(process.major_faults, std::memory_order_relaxed);
+}
+
+static void write_header(std::ostream &os) {
+    os << "snapshot,process,ops,current_size_allocated,peak_size_allocated,"
+       << "total_size_allocated,total_number_of_allocations,"
+       << "freed_allocation_size,vm_rss_bytes,pss_bytes,private_dirty_bytes,"
+       << "minor_faults,major_faults\n";
+}
+
+static constexpr usize SLOT_FIELDS = 11;
+
+static void slot_values(const ProcessSlot &s, usize out[SLOT_FIELDS]) {
+    const std::atomic<usize> *fields[SLOT_FIELDS] = {
+        &s.ops,         &s.current_size, &s.peak_size,     &s.total_size,
+        &s.allocations, &s.freed,        &s.rss,           &s.pss,
+        &s.private_dirty, &s.minor_faults, &s.major_faults,
+    };
+    for (usize c = 0; c < SLOT_FIELDS; c++) {
+        out[c] = fields[c]->load(std::memory_order_relaxed);
+    }
+}
+
+static void write_row(std::ostream &os, usize snapshot,
+                      const std::string &process,
+                      const usize values[SLOT_FIELDS]) {
+    os << snapshot << "," << process;
+    for (usize c = 0; c < SLOT_FIELDS; c++) {
+        os << "," << values[c];
+    }
+    os << "\n";
+}
+
+/// @brief One row per child and a "total" row summing all of them
+static void write_snapshot(std::ostream &os, usize snapshot,
+                           ProcessSlot *slots, usize count) {
+    usize total[SLOT_FIELDS] = {};
+    for (usize k = 0; k < count; k++) {
+        usize row[SLOT_FIELDS];
+        slot_values(slots[k], row);
+        write_row(os, snapshot, std::to_string(k), row);
+        for (usize c = 0; c < SLOT_FIELDS; c++) {
+            total[c] += row[c];
+        }
+    }
+    write_row(os, snapshot, "total", total);
+}
+
+void monitor_processes(const Args &args, ProcessSlot *slots,
+                       std::vector<pid_t> &pids, std::ofstream &output) {
+    usize count = pids.size();
+
+    utils::ProgressBar progress =
+        utils::ProgressBar::from_iterations(args.iterations.as.i);
+    if (args.duration_sec.as.i > 0) {
+        progress = utils::ProgressBar::from_duration(args.duration_sec.as.i);
+    }
+    progress.display(args.display.as.b);
+
+    if (output.is_open()) {
+        write_header(output);
+    }
+
+    Int interval = (args.snap_interval.as.i > 0) ? args.snap_interval.as.i : 1;
+    usize next_snap = interval;
+    usize snapshot = 0;
+    usize running = count;
+    usize written = (usize)-1; // total ops of the last snapshot
+    while (running > 0) {
+        usize total = 0;
+        for (usize k = 0; k < count; k++) {
+            total += slots[k].ops.load(std::memory_order_relaxed);
+        }
+
+        progress.update_to(total);
+        if (output.is_open() && total >= next_snap) {
+            write_snapshot(output, snapshot++, slots, count);
+            next_snap = (total / interval + 1) * interval;
+            written = total;
+        }
+
+        for (usize k = 0; k < count; k++) {
+            if (pids[k] <= 0) {
+                continue;
+            }
+
+            int status;
+            if (waitpid(pids[k], &status, WNOHANG) == pids[k]) {
+                if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                    log_error("Process %zu (pid %d) failed with status %d", k,
+                              pids[k], status);
+                }
+                pids[k] = 0;
+                running--;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    progress.finish();
+
+    usize total = 0;
+    for (usize k = 0; k < count; k++) {
+        total += slots[k].ops.load(std::memory_order_relaxed);
+    }
+    if (output.is_open() && total != written) {
+        write_snapshot(output, snapshot, slots, count);
+    }
+}
+
+void child_loop(const Args &args, usize k, ProcessSlot &slot,
+                const std::function<void()> &step) {
+    usize processes = args.processes.as.i;
+
+    // publish often enough for the parent's snapshot interval
+    usize every = (args.snap_interval.as.i > 0)
+                      ? std::max<usize>(args.snap_interval.as.i / processes, 1)
+                      : 0;
+
+    utils::ProgressBar progress = utils::ProgressBar::from_iterations(
+        split_work(args.iterations.as.i, processes, k));
+    if (args.duration_sec.as.i > 0) {
+        progress = utils::ProgressBar::from_duration(args.duration_sec.as.i);
+    }
+    progress.display(false);
+
+    auto begin = std::chrono::steady_clock::now();
+    while (progress.has_next()) {
+        usize i = progress.next();
+        step();
+        backend::maintain(i);
+        reclaim::tick(i);
+
+        slot.ops.store(i, std::memory_order_relaxed);
+        if (every > 0 && (i % every) == 0) {
+            publish(slot);
+        }
+    }
+
+    slot.elapsed_us.store(std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - begin)
+                              .count(),
+                          std::memory_order_relaxed);
+    publish(slot);
+}
+
+[[noreturn]] static void process_child(const Args &args, usize k,
+                                       ProcessSlot &slot) {
+    usize processes = args.processes.as.i;
+
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+    tracker.init();
+    tracker.setSampleOnAlloc(false);
+
+    Random rng = Random(args.seed.as.i).stream(k);
+    action::init_actions(args);
+
+    {
+        Pool pool =
+            Pool(std::max<usize>(split_work(args.capacity.as.i, processes, k), 1));
+        // last publish happens with the pool still populated
+        child_loop(args, k, slot,
+                   [&]() { action::block_action(pool, args, rng); });
+    }
+
+    reclaim::shutdown();
+    slot.finished.store(true, std::memory_order_release);
+    _exit(0); // skip parent's atexit handlers and stream buffers
+}
+
+void run_processes(const Args &args, std::ofstream &output) {
+    usize processes = args.processes.as.i;
+    ProcessSlot *slots = map_process_slots(processes);
+
+    // anything buffered now would be printed once per child
+    std::cout.flush();
+    fflush(stdout);
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<pid_t> pids(processes, 0);
+    for (usize k = 0; k < processes; k++) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            panic("fork failed: %s", strerror(errno));
+        }
+        if (pid == 0) {
+            process_child(args, k, slots[k]);
+        }
+        pids[k] = pid;
+    }
+
+    monitor_processes(args, slots, pids, output);
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+
+    std::vector<WorkerState> workers(processes);
+    for (usize k = 0; k < processes; k++) {
+        workers[k].role = "process";
+        workers[k].ops.store(slots[k].ops.load(std::memory_order_relaxed));
+        workers[k].seconds = slots[k].elapsed_us.load() / 1e6;
+    }
+    print_report("processes", workers, seconds);
+
+    usize pss = 0;
+    for (usize k = 0; k < processes; k++) {
+        pss += slots[k].pss.load(std::memory_order_relaxed);
+    }
+    std::cout << "  total pss: " << pss << " B\n";
+
+    unmap_process_slots(slots, processes);
+}
+
+} // namespace scenario
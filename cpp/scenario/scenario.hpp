@@ -0,0 +1,118 @@
+#ifndef SCENARIO_HPP
+#define SCENARIO_HPP
+
+#include "../../c/utils/args_parser.h"
+#include "../../c/utils/common.h"
+
+#include "../utils/common.hpp"
+#include "../utils/progress.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <functional>
+
+#include <sys/types.h>
+
+namespace scenario {
+
+/// Per-worker progress, padded so workers don't share cache lines
+struct alignas(64) WorkerState {
+    std::atomic<usize> ops{0};
+    std::atomic<bool> finished{false};
+    double seconds = 0.0;
+    const char *role = "thread";
+    bool paced = true; // ops count toward --iterations and snapshots
+};
+
+/// Counters of one forked child, in memory shared with the parent. Plain
+/// lock-free atomics, so they work across processes
+struct alignas(64) ProcessSlot {
+    std::atomic<usize> ops{0};
+    std::atomic<usize> elapsed_us{0};
+    std::atomic<bool> finished{false};
+
+    // tracker counters
+    std::atomic<usize> current_size{0};
+    std::atomic<usize> peak_size{0};
+    std::atomic<usize> total_size{0};
+    std::atomic<usize> allocations{0};
+    std::atomic<usize> freed{0};
+
+    // procfs samples (bytes)
+    std::atomic<usize> rss{0};
+    std::atomic<usize> pss{0};
+    std::atomic<usize> private_dirty{0};
+    std::atomic<usize> minor_faults{0};
+    std::atomic<usize> major_faults{0};
+};
+
+/// @brief Monotonic timestamp for latency measurements
+static inline u64 now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/// @brief Part `k` of `total` units split between `workers`
+usize split_work(usize total, usize workers, usize k);
+
+/// @brief Drive progress bar and snapshots while workers run. Returns
+///        when every worker has finished, raising `stop` once a
+///        duration based run is over
+void monitor(const Args &args, std::vector<WorkerState> &workers,
+             std::atomic<bool> &stop, std::ofstream &output);
+
+/// @brief Shared anonymous mapping with `count` slots, inherited by fork
+ProcessSlot *map_process_slots(usize count);
+void unmap_process_slots(ProcessSlot *slots, usize count);
+
+/// @brief Child side: copy tracker counters and procfs samples to `slot`
+void publish(ProcessSlot &slot);
+
+/// @brief Child side loop of forked scenarios: calls `step` for the
+///        child's share of iterations (or until the duration is over) and
+///        publishes to `slot` at the parent's snapshot interval and once at
+///        the end
+void child_loop(const Args &args, usize k, ProcessSlot &slot,
+                const std::function<void()> &step);
+
+/// @brief Parent side of `monitor`: progress bar, one CSV row per child
+///        (plus a total row) at every snapshot, reaping of children
+void monitor_processes(const Args &args, ProcessSlot *slots,
+                       std::vector<pid_t> &pids, std::ofstream &output);
+
+/// @brief Print aggregate and per-thread throughput
+void print_report(const char *name, const std::vector<WorkerState> &workers,
+                  double seconds);
+
+/// @brief N independent loops, each with its own pool shard and RNG
+void run_sharded(const Args &args, std::ofstream &output);
+
+/// @brief Producers allocate blocks and hand them over lock-free rings to
+///        consumers, which free them according to the policy
+void run_handoff(const Args &args, std::ofstream &output);
+
+/// @brief N loops on one pool instance, lock-free for LIFO/FIFO and behind
+///        a lock for other policies
+void run_shared(const Args &args, std::ofstream &output);
+
+/// @brief Fork-join tasks on per-thread Chase-Lev deques with stealing,
+///        children free the scratch blocks their parents allocated
+void run_steal(const Args &args, std::ofstream &output);
+
+/// @brief K coroutine sessions per entry of --sessions, multiplexed on the
+///        worker threads, each with its own small pool
+void run_sessions(const Args &args, std::ofstream &output);
+
+/// @brief N forked copies of the single loop, each with its own heap
+void run_processes(const Args &args, std::ofstream &output);
+
+/// @brief Parent fills one pool, then forks --processes children that
+///        free, allocate and write to the inherited blocks, so every
+///        touched page is copied
+void run_cow(const Args &args, std::ofstream &output);
+
+} // namespace scenario
+
+#endif // SCENARIO_HPP
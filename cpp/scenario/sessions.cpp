@@ -0,0 +1,174 @@
+#include "scenario.hpp"
+
+#include "../actions/actions.hpp"
+#include "../backend/backend.hpp"
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+#include "../reclaim/reclaim.hpp"
+#include "../tracker/tracker.hpp"
+#include "../utils/coroutine.hpp"
+
+#include <barrier>
+#include <iomanip>
+#include <string>
+#include <thread>
+
+namespace scenario {
+
+/// Result of running K sessions
+struct Phase {
+    usize sessions = 0;
+    usize ops = 0;
+    double seconds = 0.0;
+    usize rss_bytes = 0;
+    usize live_bytes = 0;
+};
+
+/// @brief One client: own pool, own RNG stream, yields after every action
+static utils::Coroutine session(const Args &args, Random rng) {
+    Pool pool = Pool(args.session_capacity.as.i);
+
+    while (true) {
+        action::block_action(pool, args, rng);
+        co_await std::suspend_always{};
+    }
+}
+
+static void session_worker(const Args &args, usize sessions, usize k,
+                           std::barrier<> &start, std::barrier<> &hold,
+                           std::atomic<bool> &stop, WorkerState &state) {
+    usize threads = args.threads.as.i;
+    bool timed = args.duration_sec.as.i > 0;
+
+    usize count = split_work(sessions, threads, k);
+    usize first = k * (sessions / threads) + std::min(k, sessions % threads);
+
+    // workers past the session count have nothing to schedule, the busy
+    // ones share all iterations
+    if (count == 0) {
+        state.finished.store(true, std::memory_order_release);
+        start.arrive_and_wait();
+        hold.arrive_and_wait();
+        return;
+    }
+    usize busy = std::min(threads, sessions);
+    usize iterations = split_work(args.iterations.as.i, busy, k);
+
+    action::init_actions(args);
+    Int initial_trend = action::exchange_trend_state(0);
+
+    {
+        // frames are created suspended, pools fill up on the first resumes
+        std::vector<utils::Coroutine> clients;
+        std::vector<Int> trends(count, initial_trend);
+        // session `first + j` gets worker stream `first + j`, one jump on
+        // from the previous session
+        Random next = Random(args.seed.as.i).stream(first);
+        clients.reserve(count);
+        for (usize j = 0; j < count; j++) {
+            clients.push_back(session(args, next));
+            next.jump();
+        }
+
+        start.arrive_and_wait();
+        auto begin = std::chrono::steady_clock::now();
+
+        usize i = 0;
+        usize j = 0;
+        while (timed ? !stop.load(std::memory_order_relaxed) : i < iterations) {
+            action::exchange_trend_state(trends[j]);
+            clients[j].resume();
+            trends[j] = action::exchange_trend_state(0);
+            j = (j + 1 < count) ? j + 1 : 0;
+
+            i++;
+            backend::maintain(i);
+            reclaim::tick(i);
+            state.ops.store(i, std::memory_order_relaxed);
+        }
+
+        state.seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - begin)
+                            .count();
+        state.finished.store(true, std::memory_order_release);
+
+        // keep every session alive until memory has been measured
+        hold.arrive_and_wait();
+    }
+}
+
+static Phase run_phase(const Args &args, usize sessions,
+                       std::ofstream &output) {
+    usize threads = args.threads.as.i;
+
+    std::vector<WorkerState> workers(threads);
+    std::atomic<bool> stop{false};
+    std::barrier<> start((std::ptrdiff_t)threads + 1);
+    std::barrier<> hold((std::ptrdiff_t)threads + 1);
+
+    std::vector<std::thread> handles;
+    for (usize k = 0; k < threads; k++) {
+        workers[k].role = "scheduler";
+        handles.emplace_back(session_worker, std::cref(args), sessions, k,
+                             std::ref(start), std::ref(hold), std::ref(stop),
+                             std::ref(workers[k]));
+    }
+
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+
+    monitor(args, workers, stop, output);
+
+    Phase phase;
+    phase.sessions = sessions;
+    phase.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count();
+    for (const WorkerState &w : workers) {
+        phase.ops += w.ops.load(std::memory_order_relaxed);
+    }
+
+    tracker::Tracker &tracker = tracker::Tracker::instance();
+    tracker::SystemMemoryStats system;
+    system.readFromProc();
+    tracker.merge();
+    phase.rss_bytes = system.vmRssBytes();
+    phase.live_bytes = tracker.currentSizeAllocated();
+    if (output.is_open()) {
+        tracker.write(output);
+    }
+
+    hold.arrive_and_wait();
+    for (std::thread &t : handles) {
+        t.join();
+    }
+
+    std::string name = "sessions K=" + std::to_string(sessions);
+    print_report(name.c_str(), workers, phase.seconds);
+    return phase;
+}
+
+void run_sessions(const Args &args, std::ofstream &output) {
+    IntList list = args.sessions.as.il;
+
+    std::vector<Phase> phases;
+    for (u32 i = 0; i < list.count; i++) {
+        phases.push_back(run_phase(args, list.items[i], output));
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "sessions, ops/s, rss MiB, live MiB, rss/live\n";
+    for (const Phase &p : phases) {
+        double rss = p.rss_bytes / (1024.0 * 1024.0);
+        double live = p.live_bytes / (1024.0 * 1024.0);
+        std::cout << "  " << p.sessions << ", "
+                  << ((p.seconds > 0.0) ? p.ops / p.seconds : 0.0) << ", "
+                  << rss << ", " << live << ", "
+                  << std::setprecision(2)
+                  << ((p.live_bytes > 0) ? (double)p.rss_bytes / p.live_bytes
+                                         : 0.0)
+                  << std::setprecision(1) << "\n";
+    }
+}
+
+} // namespace scenario
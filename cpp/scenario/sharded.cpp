@@ -0,0 +1,77 @@
+#include "scenario.hpp"
+
+#include "../actions/actions.hpp"
+#include "../backend/backend.hpp"
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+#include "../reclaim/reclaim.hpp"
+
+#include <barrier>
+#include <thread>
+
+namespace scenario {
+
+static void sharded_worker(const Args &args, usize k, std::barrier<> &start,
+                           std::atomic<bool> &stop, WorkerState &state) {
+    usize threads = args.threads.as.i;
+    bool timed = args.duration_sec.as.i > 0;
+    usize iterations = split_work(args.iterations.as.i, threads, k);
+    usize capacity = split_work(args.capacity.as.i, threads, k);
+
+    // stream k of the run's seed, same seed and thread count give every
+    // worker the same draws again
+    Random rng = Random(args.seed.as.i).stream(k);
+    action::init_actions(args);
+
+    {
+        Pool pool = Pool(std::max<usize>(capacity, 1));
+
+        start.arrive_and_wait();
+        auto begin = std::chrono::steady_clock::now();
+
+        usize i = 0;
+        while (timed ? !stop.load(std::memory_order_relaxed) : i < iterations) {
+            action::block_action(pool, args, rng);
+            i++;
+            backend::maintain(i);
+            reclaim::tick(i);
+            state.ops.store(i, std::memory_order_relaxed);
+        }
+
+        state.seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - begin)
+                            .count();
+    }
+
+    state.finished.store(true, std::memory_order_release);
+}
+
+void run_sharded(const Args &args, std::ofstream &output) {
+    usize threads = args.threads.as.i;
+
+    std::vector<WorkerState> workers(threads);
+    std::atomic<bool> stop{false};
+    std::barrier<> start((std::ptrdiff_t)threads + 1);
+
+    std::vector<std::thread> handles;
+    for (usize k = 0; k < threads; k++) {
+        handles.emplace_back(sharded_worker, std::cref(args), k,
+                             std::ref(start), std::ref(stop),
+                             std::ref(workers[k]));
+    }
+
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+
+    monitor(args, workers, stop, output);
+    for (std::thread &t : handles) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    print_report("sharded", workers, seconds);
+}
+
+} // namespace scenario
@@ -0,0 +1,117 @@
+#include "scenario.hpp"
+
+#include "../actions/actions.hpp"
+#include "../backend/backend.hpp"
+#include "../pool/shared_pool.hpp"
+#include "../random/random.hpp"
+#include "../reclaim/reclaim.hpp"
+
+#include <barrier>
+#include <thread>
+
+namespace scenario {
+
+/// @brief Same decisions as `action::block_action`, against the shared pool
+static void shared_action(SharedPool &pool, const Args &args, Random &rng,
+                          usize &rejected) {
+    if (args.ttl_mode.as.e != TTL_OFF) {
+        pool.update_and_prune();
+    }
+
+    if ((args.resize_freq.as.f > 0.0) && (pool.count() > 0) &&
+        (rng.uniform01() < args.resize_freq.as.f)) {
+        pool.resize_block(action::get_block_size(args, rng), rng);
+        return;
+    }
+
+    bool alloc = (pool.count() < pool.capacity) &&
+                 (rng.uniform01() < args.alloc_freq.as.f);
+    if (!alloc) {
+        pool.del_block(rng);
+        return;
+    }
+
+    // allocate outside of the pool, another thread may fill the last slot
+    // meanwhile, then the block is simply freed again
+    Int size = action::get_block_size(args, rng);
+    Block block = Block(size, action::get_block_ttl(args, rng, size));
+    if (!pool.add_block(std::move(block))) {
+        rejected++;
+    }
+}
+
+static void shared_worker(const Args &args, usize k, SharedPool &pool,
+                          std::barrier<> &start, std::atomic<bool> &stop,
+                          WorkerState &state, usize &rejected) {
+    bool timed = args.duration_sec.as.i > 0;
+    usize iterations =
+        split_work(args.iterations.as.i, args.threads.as.i, k);
+
+    Random rng = Random(args.seed.as.i).stream(k);
+    action::init_actions(args);
+
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+
+    usize i = 0;
+    while (timed ? !stop.load(std::memory_order_relaxed) : i < iterations) {
+        shared_action(pool, args, rng, rejected);
+        i++;
+        backend::maintain(i);
+        reclaim::tick(i);
+        state.ops.store(i, std::memory_order_relaxed);
+    }
+
+    state.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - begin)
+                        .count();
+    state.finished.store(true, std::memory_order_release);
+}
+
+void run_shared(const Args &args, std::ofstream &output) {
+    usize threads = args.threads.as.i;
+
+    SharedPool pool = SharedPool(args.capacity.as.i, (Policy)args.policy.as.e,
+                                 (Lock)args.lock.as.e);
+    if (pool.is_lock_free() && args.ttl_mode.as.e != TTL_OFF) {
+        log_warn("TTL is ignored by the lock-free shared pool (policy %s)",
+                 policies[args.policy.as.e]);
+    }
+
+    std::vector<WorkerState> workers(threads);
+    std::vector<usize> rejected(threads, 0);
+    std::atomic<bool> stop{false};
+    std::barrier<> start((std::ptrdiff_t)threads + 1);
+
+    std::vector<std::thread> handles;
+    for (usize k = 0; k < threads; k++) {
+        handles.emplace_back(shared_worker, std::cref(args), k,
+                             std::ref(pool), std::ref(start), std::ref(stop),
+                             std::ref(workers[k]), std::ref(rejected[k]));
+    }
+
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+
+    monitor(args, workers, stop, output);
+    for (std::thread &t : handles) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    print_report("shared", workers, seconds);
+
+    usize total_rejected = 0;
+    for (usize r : rejected) {
+        total_rejected += r;
+    }
+    const concurrent::Contention &c = concurrent::contention;
+    std::cout << "  " << (pool.is_lock_free() ? "lock-free" : locks[args.lock.as.e])
+              << ": " << c.cas_retries << " CAS retries, " << c.lock_waits
+              << " lock waits, " << c.lock_wait_ns / 1e6 << " ms waited, "
+              << total_rejected << " blocks rejected (pool full)\n";
+}
+
+} // namespace scenario
@@ -0,0 +1,237 @@
+#include "scenario.hpp"
+
+#include "../actions/actions.hpp"
+#include "../backend/backend.hpp"
+#include "../concurrent/deque.hpp"
+#include "../pool/pool.hpp"
+#include "../random/random.hpp"
+#include "../reclaim/reclaim.hpp"
+#include "../tracker/tracker.hpp"
+
+#include <barrier>
+#include <iomanip>
+#include <thread>
+
+namespace scenario {
+
+static constexpr usize DEQUE_CAPACITY = 1024;
+
+/// One iteration of `block_action` plus the scratch block its parent
+/// allocated for it
+struct Task {
+    Block scratch;
+    u64 created_ns;
+    u32 depth;
+    u32 owner; // worker that created the task
+};
+
+struct StealStats {
+    usize steals = 0;
+    usize steal_attempts = 0;
+    usize cross_frees = 0; // scratch blocks freed on another worker
+    usize inline_runs = 0; // deque was full, child ran immediately
+    u64 latency_sum_ns = 0;
+    u64 latency_max_ns = 0;
+
+    // allocator counters of the worker's tracker shard
+    usize allocations = 0;
+    usize allocated_bytes = 0;
+    usize freed_bytes = 0;
+};
+
+/// Task budget and termination, shared by all workers
+struct Scheduler {
+    const Args &args;
+    std::atomic<bool> &stop;
+    alignas(64) std::atomic<usize> created{0};
+    alignas(64) std::atomic<usize> pending{0};
+
+    /// @brief Claim one task from the budget (iterations or duration)
+    bool reserve() {
+        if (self.args.duration_sec.as.i > 0) {
+            return !self.stop.load(std::memory_order_relaxed);
+        }
+
+        usize limit = self.args.iterations.as.i;
+        if (self.created.load(std::memory_order_relaxed) >= limit) {
+            return false;
+        }
+        return self.created.fetch_add(1, std::memory_order_relaxed) < limit;
+    }
+};
+
+struct alignas(64) StealWorker {
+    u32 id;
+    concurrent::StealDeque<Task> deque;
+    Random rng;
+    StealStats stats;
+
+    StealWorker(u32 id, const Random &rng)
+        : id(id), deque(DEQUE_CAPACITY), rng(rng) {}
+};
+
+static Task *make_task(const Args &args, StealWorker &w, u32 depth) {
+    Block scratch = Block(action::get_block_size(args, w.rng));
+    return new Task{std::move(scratch), now_ns(), depth, w.id};
+}
+
+static void run_task(Task *task, Pool &pool, const Args &args,
+                     Scheduler &sched, StealWorker &w, WorkerState &state) {
+    u64 latency = now_ns() - task->created_ns;
+    w.stats.latency_sum_ns += latency;
+    w.stats.latency_max_ns = std::max(w.stats.latency_max_ns, latency);
+
+    // child frees what the parent allocated, possibly on another core
+    if (task->owner != w.id) {
+        w.stats.cross_frees++;
+    }
+    task->scratch = Block();
+
+    action::block_action(pool, args, w.rng);
+
+    if (task->depth < args.max_depth.as.i &&
+        w.rng.uniform01() < args.spawn_freq.as.f) {
+        for (usize c = 0; c < args.fanout.as.i && sched.reserve(); c++) {
+            Task *child = make_task(args, w, task->depth + 1);
+            sched.pending.fetch_add(1, std::memory_order_relaxed);
+            if (!w.deque.push(child)) {
+                w.stats.inline_runs++;
+                run_task(child, pool, args, sched, w, state);
+            }
+        }
+    }
+
+    delete task;
+    usize ops = state.ops.load(std::memory_order_relaxed) + 1;
+    state.ops.store(ops, std::memory_order_relaxed);
+    backend::maintain(ops);
+    reclaim::tick(ops);
+    sched.pending.fetch_sub(1, std::memory_order_release);
+}
+
+static Task *try_steal(std::vector<std::unique_ptr<StealWorker>> &workers,
+                       StealWorker &w) {
+    usize n = workers.size();
+    if (n < 2) {
+        return nullptr;
+    }
+
+    usize victim = w.rng.uniform(0, n - 1);
+    if (victim >= w.id) {
+        victim++; // never ourselves
+    }
+
+    w.stats.steal_attempts++;
+    Task *task = workers[victim]->deque.steal();
+    if (task != nullptr) {
+        w.stats.steals++;
+    }
+    return task;
+}
+
+static void steal_worker(const Args &args, usize k,
+                         std::vector<std::unique_ptr<StealWorker>> &workers,
+                         Scheduler &sched, std::barrier<> &start,
+                         WorkerState &state) {
+    StealWorker &w = *workers[k];
+    usize capacity = split_work(args.capacity.as.i, workers.size(), k);
+    action::init_actions(args);
+
+    {
+        Pool pool = Pool(std::max<usize>(capacity, 1));
+
+        start.arrive_and_wait();
+        auto begin = std::chrono::steady_clock::now();
+
+        while (true) {
+            Task *task = w.deque.pop();
+            if (task == nullptr) {
+                task = try_steal(workers, w);
+            }
+            if (task == nullptr && sched.reserve()) {
+                sched.pending.fetch_add(1, std::memory_order_relaxed);
+                task = make_task(args, w, 0);
+            }
+
+            if (task != nullptr) {
+                run_task(task, pool, args, sched, w, state);
+                continue;
+            }
+
+            // budget is gone, wait until every queued task has run
+            if (sched.pending.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+
+        state.seconds = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - begin)
+                            .count();
+    }
+
+    const tracker::Shard &shard = tracker::Tracker::instance().threadShard();
+    w.stats.allocations = shard.total_number_of_allocations.get();
+    w.stats.allocated_bytes = shard.total_size_allocated.get();
+    w.stats.freed_bytes = shard.freed_allocation_size.get();
+
+    state.finished.store(true, std::memory_order_release);
+}
+
+static void print_steal(const std::vector<std::unique_ptr<StealWorker>> &workers,
+                        const std::vector<WorkerState> &states) {
+    for (usize k = 0; k < workers.size(); k++) {
+        const StealStats &s = workers[k]->stats;
+        usize tasks = states[k].ops.load(std::memory_order_relaxed);
+        double n = (tasks > 0) ? (double)tasks : 1.0;
+
+        std::cout << std::fixed << std::setprecision(1) << "  worker " << k
+                  << ": " << s.steals << "/" << s.steal_attempts
+                  << " steals, " << s.cross_frees << " cross frees, "
+                  << s.inline_runs << " inline, latency avg "
+                  << s.latency_sum_ns / n / 1e3 << " us max "
+                  << s.latency_max_ns / 1e3 << " us, " << s.allocations
+                  << " allocs, " << s.allocated_bytes << " B allocated, "
+                  << s.freed_bytes << " B freed\n";
+    }
+}
+
+void run_steal(const Args &args, std::ofstream &output) {
+    usize threads = args.threads.as.i;
+
+    Random root = Random(args.seed.as.i);
+    std::vector<std::unique_ptr<StealWorker>> workers;
+    for (usize k = 0; k < threads; k++) {
+        workers.push_back(
+            std::make_unique<StealWorker>((u32)k, root.stream(k)));
+    }
+
+    std::vector<WorkerState> states(threads);
+    std::atomic<bool> stop{false};
+    Scheduler sched = {args, stop};
+    std::barrier<> start((std::ptrdiff_t)threads + 1);
+
+    std::vector<std::thread> handles;
+    for (usize k = 0; k < threads; k++) {
+        states[k].role = "worker";
+        handles.emplace_back(steal_worker, std::cref(args), k,
+                             std::ref(workers), std::ref(sched),
+                             std::ref(start), std::ref(states[k]));
+    }
+
+    start.arrive_and_wait();
+    auto begin = std::chrono::steady_clock::now();
+
+    monitor(args, states, stop, output);
+    for (std::thread &t : handles) {
+        t.join();
+    }
+
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - begin)
+                         .count();
+    print_report("steal", states, seconds);
+    print_steal(workers, states);
+}
+
+} // namespace scenario
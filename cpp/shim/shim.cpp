@@ -0,0 +1,155 @@
+// Allocation interposition shim, load with
+//   LD_PRELOAD=./build/libcpp-shim.so ./build/cpp-test ...
+// Every heap call of the process is forwarded to glibc and accounted in
+// per-thread counters, which Tracker reads through `cpp_shim_query`.
+
+#include "shim.hpp"
+
+#if defined(__GLIBC__)
+
+#include <atomic>
+#include <cerrno>
+
+#include <malloc.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t n, size_t size);
+void *__libc_realloc(void *p, size_t size);
+void *__libc_memalign(size_t align, size_t size);
+void __libc_free(void *p);
+}
+
+namespace shim {
+
+static constexpr u32 MAX_SLOTS = 256;
+
+// One writer per slot (except the last one, shared by overflow threads),
+// so increments never contend
+struct alignas(64) Slot {
+    std::atomic<u64> allocations;
+    std::atomic<u64> frees;
+    std::atomic<u64> allocated_bytes;
+    std::atomic<u64> freed_bytes;
+};
+
+static Slot slots[MAX_SLOTS];
+static std::atomic<u32> slot_count{0};
+
+// initial-exec: TLS access must not allocate, we are the allocator
+static thread_local Slot *slot __attribute__((tls_model("initial-exec"))) =
+    nullptr;
+
+static inline Slot &local() {
+    if (slot == nullptr) {
+        u32 idx = slot_count.fetch_add(1, std::memory_order_relaxed);
+        slot = &slots[(idx < MAX_SLOTS) ? idx : MAX_SLOTS - 1];
+    }
+    return *slot;
+}
+
+static inline void on_alloc(void *p) {
+    if (p == nullptr) {
+        return;
+    }
+    Slot &s = local();
+    s.allocations.fetch_add(1, std::memory_order_relaxed);
+    s.allocated_bytes.fetch_add(malloc_usable_size(p),
+                                std::memory_order_relaxed);
+}
+
+static inline void on_free(void *p) {
+    if (p == nullptr) {
+        return;
+    }
+    Slot &s = local();
+    s.frees.fetch_add(1, std::memory_order_relaxed);
+    s.freed_bytes.fetch_add(malloc_usable_size(p), std::memory_order_relaxed);
+}
+
+} // namespace shim
+
+extern "C" {
+
+void *malloc(size_t size) noexcept {
+    void *p = __libc_malloc(size);
+    shim::on_alloc(p);
+    return p;
+}
+
+void *calloc(size_t n, size_t size) noexcept {
+    void *p = __libc_calloc(n, size);
+    shim::on_alloc(p);
+    return p;
+}
+
+void *realloc(void *p, size_t size) noexcept {
+    if (p == nullptr) {
+        return malloc(size);
+    }
+    if (size == 0) {
+        free(p);
+        return nullptr;
+    }
+
+    // account before the call, `p` may be gone afterwards
+    shim::on_free(p);
+    void *q = __libc_realloc(p, size);
+    if (q == nullptr) {
+        shim::on_alloc(p); // original block is untouched on failure
+        return nullptr;
+    }
+    shim::on_alloc(q);
+    return q;
+}
+
+void free(void *p) noexcept {
+    shim::on_free(p);
+    __libc_free(p);
+}
+
+void *memalign(size_t align, size_t size) noexcept {
+    void *p = __libc_memalign(align, size);
+    shim::on_alloc(p);
+    return p;
+}
+
+void *aligned_alloc(size_t align, size_t size) noexcept {
+    return memalign(align, size);
+}
+
+int posix_memalign(void **out, size_t align, size_t size) noexcept {
+    if (align < sizeof(void *) || (align & (align - 1)) != 0) {
+        return EINVAL;
+    }
+
+    void *p = memalign(align, size);
+    if (p == nullptr) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+void cpp_shim_query(ShimStats *out) {
+    *out = ShimStats{};
+
+    u32 count = shim::slot_count.load(std::memory_order_relaxed);
+    if (count > shim::MAX_SLOTS) {
+        count = shim::MAX_SLOTS;
+    }
+
+    for (u32 i = 0; i < count; i++) {
+        shim::Slot &s = shim::slots[i];
+        out->allocations += s.allocations.load(std::memory_order_relaxed);
+        out->frees += s.frees.load(std::memory_order_relaxed);
+        out->allocated_bytes +=
+            s.allocated_bytes.load(std::memory_order_relaxed);
+        out->freed_bytes += s.freed_bytes.load(std::memory_order_relaxed);
+    }
+    out->threads = count;
+}
+
+} // extern "C"
+
+#endif // __GLIBC__
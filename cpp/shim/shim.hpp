@@ -0,0 +1,30 @@
+#ifndef SHIM_HPP
+#define SHIM_HPP
+
+#include "../../c/utils/common.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/// Whole process heap usage as seen by the LD_PRELOAD shim
+typedef struct {
+    u64 allocations;     // malloc/calloc/realloc/memalign calls
+    u64 frees;           // free calls (and realloc moves)
+    u64 allocated_bytes; // usable bytes handed out
+    u64 freed_bytes;     // usable bytes returned
+    u32 threads;         // threads that touched the heap
+} ShimStats;
+
+#define SHIM_QUERY_SYMBOL "cpp_shim_query"
+
+typedef void (*ShimQueryFn)(ShimStats *out);
+
+/// @brief Sum per-thread counters, exported by build/libcpp-shim.so
+void cpp_shim_query(ShimStats *out);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif // SHIM_HPP
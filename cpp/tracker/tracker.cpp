@@ -1,5 +1,15 @@
 #include "tracker.hpp"
 
+#include <algorithm>
+#include <chrono>
+
+#include <dlfcn.h>
+#include <sys/resource.h>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
 namespace tracker
 {
     bool SystemMemoryStats::readFromProc() {
@@ -37,58 +47,410 @@ namespace tracker
 
         return true;
     }
+
+    bool ProcessStats::readFromProc() {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            minor_faults = usage.ru_minflt;
+            major_faults = usage.ru_majflt;
+            user_time_us = usage.ru_utime.tv_sec * 1000000 + usage.ru_utime.tv_usec;
+            system_time_us = usage.ru_stime.tv_sec * 1000000 + usage.ru_stime.tv_usec;
+        }
+
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+        heap_free = mallinfo2().fordblks;
+#endif
+
+        std::ifstream smaps_file("/proc/self/smaps_rollup");
+        if (!smaps_file.is_open()) {
+            return false;
+        }
+
+        std::string line;
+        while (std::getline(smaps_file, line)) {
+            std::istringstream iss(line);
+            std::string key;
+            size_t value;
+
+            if (!(iss >> key >> value)) {
+                continue;
+            }
+
+            if (key == "AnonHugePages:")
+                anon_huge_pages = value;
+            else if (key == "Pss:")
+                pss = value;
+            else if (key == "Private_Dirty:")
+                private_dirty = value;
+        }
+
+        return true;
+    }
+
+    bool HeapStats::readFromShim() {
+        static ShimQueryFn query =
+            (ShimQueryFn)dlsym(RTLD_DEFAULT, SHIM_QUERY_SYMBOL);
+        if (query == nullptr) {
+            return false;
+        }
+
+        query(&shim);
+        active = true;
+        return true;
+    }
 } // namespace tracker
 
 namespace tracker
 {
+    void SlackHistogram::writeHeader(std::ostream& os) const {
+        os << "class_min_bytes,class_max_bytes,allocations,requested_bytes,"
+           << "usable_bytes,slack_bytes\n";
+    }
+
+    void SlackHistogram::write(std::ostream& os) const {
+        for (size_t c = 0; c < CLASSES; c++) {
+            if (allocations[c] == 0) {
+                continue;
+            }
+
+            os << (1ULL << c) << ","
+               << ((c < CLASSES - 1) ? (1ULL << (c + 1)) - 1 : ~0ULL) << ","
+               << allocations[c] << ","
+               << requested_bytes[c] << ","
+               << usable_bytes[c] << ","
+               << (usable_bytes[c] - requested_bytes[c]) << "\n";
+        }
+    }
+} // namespace tracker
+
+namespace tracker
+{
+    void Shard::reset() {
+        peak_size_allocated.set(0);
+        total_size_allocated.set(0);
+        total_number_of_allocations.set(0);
+        current_size_allocated.set(0);
+        current_number_of_allocations.set(0);
+        freed_allocation_size.set(0);
+        total_number_of_resizes.set(0);
+        current_usable_size.set(0);
+        slack_histogram = SlackHistogram();
+    }
+
     Tracker& Tracker::instance() {
         static Tracker tracker = Tracker();
         return tracker;
     }
 
+    Shard& Tracker::shard() {
+        static thread_local Shard* local = nullptr;
+        if (local == nullptr) {
+            std::lock_guard<std::mutex> lock(shards_mutex_);
+            local = &shards_.emplace_back();
+        }
+        return *local;
+    }
+
     void Tracker::init() {
+        {
+            std::lock_guard<std::mutex> lock(shards_mutex_);
+            for (Shard& s : shards_) {
+                s.reset();
+            }
+        }
         peak_size_allocated_ = 0;
-        total_size_allocated_ = 0;
-        total_number_of_allocations_ = 0;
-        current_size_allocated_ = 0;
-        current_number_of_allocations_ = 0;
-        freed_allocation_size_ = 0;
-        updateSystemStats();
+        merge();
+        system_stats_.readFromProc();
+        baseline_rss_ = system_stats_.vmRssBytes();
     }
 
-    void Tracker::addAlloc(size_t size) {
-        current_number_of_allocations_++;
-        total_number_of_allocations_++;
-        current_size_allocated_ += size;
-        total_size_allocated_ += size;
-        
-        if (current_size_allocated_ > peak_size_allocated_) {
-            peak_size_allocated_ = current_size_allocated_;
+    void Tracker::applyEvent(Shard& s, const Event& event) {
+        switch (event.kind) {
+        case EVENT_ALLOC:
+            s.current_number_of_allocations.add(1);
+            s.total_number_of_allocations.add(1);
+            s.current_size_allocated.add((int64_t)event.size);
+            s.total_size_allocated.add((int64_t)event.size);
+            s.current_usable_size.add((int64_t)event.usable);
+            s.slack_histogram.add(event.size, event.usable);
+            break;
+        case EVENT_FREE:
+            s.current_number_of_allocations.add(-1);
+            s.current_size_allocated.add(-(int64_t)event.size);
+            s.current_usable_size.add(-(int64_t)event.usable);
+            s.freed_allocation_size.add((int64_t)event.size);
+            return;
+        case EVENT_RESIZE:
+            s.total_number_of_resizes.add(1);
+            s.current_usable_size.add((int64_t)event.usable - (int64_t)event.old_usable);
+            s.slack_histogram.resize(event.old_size, event.old_usable,
+                                     event.size, event.usable);
+            if (event.size > event.old_size) {
+                s.current_size_allocated.add((int64_t)(event.size - event.old_size));
+                s.total_size_allocated.add((int64_t)(event.size - event.old_size));
+            } else {
+                s.current_size_allocated.add(-(int64_t)(event.old_size - event.size));
+                s.freed_allocation_size.add((int64_t)(event.old_size - event.size));
+            }
+            break;
         }
-        
+
+        if (s.current_size_allocated.get() > s.peak_size_allocated.get()) {
+            s.peak_size_allocated.set(s.current_size_allocated.get());
+        }
+    }
+
+    static inline uint64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    EventSource* Tracker::eventSource() {
+        static thread_local EventSource* local = nullptr;
+        static thread_local bool inline_only = false; // no ring was left
+        if (local == nullptr && !inline_only) {
+            std::lock_guard<std::mutex> lock(shards_mutex_);
+            size_t idx = source_count_.load(std::memory_order_relaxed);
+            if (idx >= MAX_EVENT_SOURCES) {
+                static bool warned = false; // under shards_mutex_
+                if (!warned) {
+                    log_warn("Over %zu threads record events, the rest "
+                             "fall back to inline accounting",
+                             MAX_EVENT_SOURCES);
+                    warned = true;
+                }
+                inline_only = true;
+                return nullptr; // caller falls back to inline accounting
+            }
+            sources_[idx] = std::make_unique<EventSource>(event_ring_, (uint32_t)idx);
+            local = sources_[idx].get();
+            source_count_.store(idx + 1, std::memory_order_release);
+        }
+        return local;
+    }
+
+    bool Tracker::record(const Event& event) {
+        EventSource* src = eventSource();
+        if (src == nullptr) {
+            return false;
+        }
+
+        Event e = event;
+        e.thread = src->thread;
+        e.timestamp_ns = nowNs();
+        if (src->ring.try_push(e)) {
+            return true;
+        }
+
+        if (tracking_ == TRACKING_ASYNC_DROP) {
+            src->dropped.add(1);
+            return true;
+        }
+
+        // backpressure, wait for the aggregator
+        src->waits.add(1);
+        do {
+            std::this_thread::yield();
+        } while (!src->ring.try_push(e));
+        return true;
+    }
+
+    size_t Tracker::drain() {
+        std::lock_guard<std::mutex> lock(drain_mutex_);
+
+        size_t applied = 0;
+        size_t count = source_count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            Event e;
+            while (sources_[i]->ring.try_pop(e)) {
+                applyEvent(*async_shard_, e);
+                applied++;
+
+                int64_t lag = (int64_t)(nowNs() - e.timestamp_ns);
+                if (lag > event_lag_max_ns_.get()) {
+                    event_lag_max_ns_.set(lag);
+                }
+            }
+        }
+
+        if (applied > 0) {
+            events_applied_.add((int64_t)applied);
+        }
+        return applied;
+    }
+
+    void Tracker::setTracking(Tracking mode, size_t ring_size) {
+        if (tracking_ != TRACKING_INLINE) {
+            aggregator_stop_.store(true, std::memory_order_relaxed);
+            aggregator_.join();
+            drain();
+        }
+
+        tracking_ = mode;
+        if (mode == TRACKING_INLINE) {
+            return;
+        }
+
+        event_ring_ = ring_size;
+        if (async_shard_ == nullptr) {
+            std::lock_guard<std::mutex> lock(shards_mutex_);
+            async_shard_ = &shards_.emplace_back();
+        }
+
+        aggregator_stop_.store(false, std::memory_order_relaxed);
+        aggregator_ = std::thread([this]() {
+            while (!aggregator_stop_.load(std::memory_order_relaxed)) {
+                if (drain() == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        });
+    }
+
+    void Tracker::setSites(size_t count) {
+        sites_.clear();
+        sites_.resize(count);
+        site_ = NO_SITE;
+    }
+
+    void Tracker::chargeSite(const Event& event) {
+        if (site_ >= sites_.size()) {
+            return;
+        }
+
+        SiteStats& s = sites_[site_];
+        switch (event.kind) {
+        case EVENT_ALLOC:
+            s.allocations.add(1);
+            s.current_count.add(1);
+            s.current_size.add((int64_t)event.size);
+            break;
+        case EVENT_FREE:
+            s.frees.add(1);
+            s.current_count.add(-1);
+            s.current_size.add(-(int64_t)event.size);
+            return;
+        case EVENT_RESIZE:
+            s.resizes.add(1);
+            s.current_size.add((int64_t)event.size - (int64_t)event.old_size);
+            break;
+        }
+
+        if (s.current_size.get() > s.peak_size.get()) {
+            s.peak_size.set(s.current_size.get());
+        }
+    }
+
+    void Tracker::addAlloc(size_t size, size_t usable) {
+        Event e = {0, size, usable, 0, 0, 0, EVENT_ALLOC};
+        chargeSite(e);
+        if (tracking_ != TRACKING_INLINE && record(e)) {
+            return;
+        }
+
+        applyEvent(shard(), e);
         updateSystemStats();
     }
 
-    void Tracker::removeAlloc(size_t size) {
-        if (current_number_of_allocations_ > 0) {
-            current_number_of_allocations_--;
+    void Tracker::removeAlloc(size_t size, size_t usable) {
+        Event e = {0, size, usable, 0, 0, 0, EVENT_FREE};
+        chargeSite(e);
+        if (tracking_ != TRACKING_INLINE && record(e)) {
+            return;
         }
-        if (current_size_allocated_ >= size) {
-            current_size_allocated_ -= size;
+
+        applyEvent(shard(), e);
+        updateSystemStats();
+    }
+
+    void Tracker::resizeAlloc(size_t old_size, size_t new_size, size_t old_usable, size_t new_usable) {
+        Event e = {0, new_size, new_usable, old_size, old_usable, 0, EVENT_RESIZE};
+        chargeSite(e);
+        if (tracking_ != TRACKING_INLINE && record(e)) {
+            return;
         }
-        freed_allocation_size_ += size;
-        
+
+        applyEvent(shard(), e);
         updateSystemStats();
     }
 
+    static inline size_t clampZero(int64_t v) { return (v > 0) ? (size_t)v : 0; }
+
+    void Tracker::merge() {
+        int64_t total_size = 0, total_count = 0, current_size = 0,
+                current_count = 0, freed = 0, resizes = 0, usable = 0,
+                shard_peak = 0;
+
+        std::lock_guard<std::mutex> lock(shards_mutex_);
+        for (const Shard& s : shards_) {
+            total_size += s.total_size_allocated.get();
+            total_count += s.total_number_of_allocations.get();
+            current_size += s.current_size_allocated.get();
+            current_count += s.current_number_of_allocations.get();
+            freed += s.freed_allocation_size.get();
+            resizes += s.total_number_of_resizes.get();
+            usable += s.current_usable_size.get();
+            shard_peak = std::max(shard_peak, s.peak_size_allocated.get());
+        }
+
+        total_size_allocated_ = clampZero(total_size);
+        total_number_of_allocations_ = clampZero(total_count);
+        current_size_allocated_ = clampZero(current_size);
+        current_number_of_allocations_ = clampZero(current_count);
+        freed_allocation_size_ = clampZero(freed);
+        total_number_of_resizes_ = clampZero(resizes);
+        current_usable_size_ = clampZero(usable);
+
+        if (shards_.size() == 1) {
+            peak_size_allocated_ = clampZero(shard_peak);
+        }
+        peak_size_allocated_ = std::max(peak_size_allocated_, current_size_allocated_);
+    }
+
     void Tracker::writeHeader(std::ostream& os) const {
         os << "peak_size_allocated,total_size_allocated,total_number_of_allocations,"
            << "current_size_allocated,current_number_of_allocations,freed_allocation_size,"
            << "vm_peak_bytes,vm_size_bytes,vm_rss_bytes,vm_hwm_bytes,vm_data_bytes,"
-           << "vm_stk_bytes,vm_exe_bytes,vm_lib_bytes\n";
+           << "vm_stk_bytes,vm_exe_bytes,vm_lib_bytes,"
+           << "anon_huge_pages_bytes,minor_faults,major_faults,user_time_us,system_time_us,"
+           << "hugetlb_mappings,thp_mappings,hugetlb_fallbacks,"
+           << "total_number_of_resizes,resizes_in_place,resizes_remapped,resizes_copied,resize_time_ns,"
+           << "release_calls,released_bytes,trim_calls,trim_time_ns,"
+           << "process_heap_bytes,process_allocations,process_frees,process_heap_threads,"
+           << "current_usable_size,rounding_slack_bytes,heap_free_bytes,baseline_rss_bytes,"
+           << "cas_retries,lock_waits,lock_wait_ns,"
+           << "tracking_events,tracking_waits,tracking_dropped,tracking_lag_max_ns,"
+           << "retire_calls,retire_time_ns,retire_time_max_ns,retired_bytes,retired_bytes_peak,"
+           << "reclaim_batches,reclaim_queue_max,reclaim_lag_max_ns,reclaim_overflows,"
+           << "reclaim_limit_flushes,reclaim_flush_time_ns,live_bytes,"
+           << "handoff_sent,handoff_received,handoff_full_waits,handoff_dropped,"
+           << "handoff_latency_avg_ns,handoff_latency_max_ns,handoff_depth_avg,handoff_depth_max\n";
     }
     
-    void Tracker::write(std::ostream& os) const {
+    void Tracker::write(std::ostream& os) {
+        if (tracking_ != TRACKING_INLINE) {
+            drain(); // snapshot includes everything recorded so far
+        }
+        merge();
+
+        int64_t event_waits = 0, events_dropped = 0;
+        size_t sources = source_count_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < sources; i++) {
+            event_waits += sources_[i]->waits.get();
+            events_dropped += sources_[i]->dropped.get();
+        }
+
+        if (!sample_on_alloc_) {
+            system_stats_.readFromProc();
+        }
+        process_stats_.readFromProc();
+        heap_stats_.readFromShim();
+        backend::Stats backend_stats = backend::stats();
+        reclaim::Stats reclaim_stats = reclaim::stats();
+        scenario::HandoffStats handoff = scenario::handoff_stats();
+        double handoff_received = (handoff.received > 0) ? (double)handoff.received : 1.0;
+
         os << peak_size_allocated_ << ","
            << total_size_allocated_ << ","
            << total_number_of_allocations_ << ","
@@ -102,7 +464,77 @@ namespace tracker
            << (system_stats_.vm_data * 1024) << ","
            << (system_stats_.vm_stk * 1024) << ","
            << (system_stats_.vm_exe * 1024) << ","
-           << (system_stats_.vm_lib * 1024) << "\n";
+           << (system_stats_.vm_lib * 1024) << ","
+           << process_stats_.anonHugePagesBytes() << ","
+           << process_stats_.minor_faults << ","
+           << process_stats_.major_faults << ","
+           << process_stats_.user_time_us << ","
+           << process_stats_.system_time_us << ","
+           << backend_stats.hugetlb_mappings << ","
+           << backend_stats.thp_mappings << ","
+           << backend_stats.hugetlb_fallbacks << ","
+           << total_number_of_resizes_ << ","
+           << backend_stats.resizes_in_place << ","
+           << backend_stats.resizes_remapped << ","
+           << backend_stats.resizes_copied << ","
+           << backend_stats.resize_time_ns << ","
+           << backend_stats.release_calls << ","
+           << backend_stats.released_bytes << ","
+           << backend_stats.trim_calls << ","
+           << backend_stats.trim_time_ns << ","
+           << heap_stats_.liveBytes() << ","
+           << heap_stats_.shim.allocations << ","
+           << heap_stats_.shim.frees << ","
+           << heap_stats_.shim.threads << ","
+           << current_usable_size_ << ","
+           << ((current_usable_size_ >= current_size_allocated_) ? (current_usable_size_ - current_size_allocated_) : 0) << ","
+           << process_stats_.heap_free << ","
+           << baseline_rss_ << ","
+           << concurrent::contention.cas_retries << ","
+           << concurrent::contention.lock_waits << ","
+           << concurrent::contention.lock_wait_ns << ","
+           << events_applied_.get() << ","
+           << event_waits << ","
+           << events_dropped << ","
+           << event_lag_max_ns_.get() << ","
+           << reclaim_stats.retire_calls << ","
+           << reclaim_stats.retire_time_ns << ","
+           << reclaim_stats.retire_time_max_ns << ","
+           << reclaim_stats.retired_bytes << ","
+           << reclaim_stats.retired_bytes_peak << ","
+           << reclaim_stats.reclaim_batches << ","
+           << reclaim_stats.queue_max << ","
+           << reclaim_stats.lag_max_ns << ","
+           << reclaim_stats.overflows << ","
+           << reclaim_stats.limit_flushes << ","
+           << reclaim_stats.flush_time_ns << ","
+           // allocated and still referenced by a pool, retired excluded
+           << ((current_size_allocated_ >= reclaim_stats.retired_bytes) ? (current_size_allocated_ - reclaim_stats.retired_bytes) : 0) << ","
+           << handoff.sent << ","
+           << handoff.received << ","
+           << handoff.full_waits << ","
+           << handoff.dropped << ","
+           << (size_t)(handoff.latency_sum_ns / handoff_received) << ","
+           << handoff.latency_max_ns << ","
+           << handoff.depth_sum / handoff_received << ","
+           << handoff.depth_max << "\n";
+    }
+
+    void Tracker::writeSlackHistogram(std::ostream& os) {
+        SlackHistogram merged;
+        {
+            std::lock_guard<std::mutex> lock(shards_mutex_);
+            for (const Shard& s : shards_) {
+                for (size_t c = 0; c < SlackHistogram::CLASSES; c++) {
+                    merged.allocations[c] += s.slack_histogram.allocations[c];
+                    merged.requested_bytes[c] += s.slack_histogram.requested_bytes[c];
+                    merged.usable_bytes[c] += s.slack_histogram.usable_bytes[c];
+                }
+            }
+        }
+
+        merged.writeHeader(os);
+        merged.write(os);
     }
 
     void Tracker::printDebug() const {
@@ -4,11 +4,21 @@
 #include "../../c/utils/common.h"
 #include "../../c/utils/logging.h"
 
+#include "../backend/backend.hpp"
+#include "../concurrent/contention.hpp"
+#include "../concurrent/spsc.hpp"
+#include "../reclaim/stats.hpp"
+#include "../scenario/handoff_stats.hpp"
+#include "../shim/shim.hpp"
 #include "../utils/common.hpp"
 
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <mutex>
 #include <new>
 #include <sstream>
+#include <thread>
 #include <type_traits>
 
 namespace tracker {
@@ -53,45 +63,275 @@ class SystemMemoryStats {
     }
 };
 
+// Sampled only when a snapshot is written, reading them is too expensive
+// to do on every allocation
+class ProcessStats {
+  public:
+    size_t anon_huge_pages = 0; // THP backed anonymous memory (KB)
+    size_t pss = 0;             // proportional set size (KB)
+    size_t private_dirty = 0;   // pages written by this process only (KB)
+    size_t heap_free = 0;       // free bytes kept by malloc (mallinfo2)
+    size_t minor_faults = 0;
+    size_t major_faults = 0;
+    size_t user_time_us = 0;
+    size_t system_time_us = 0;
+
+    ProcessStats() = default;
+
+    bool readFromProc();
+
+    size_t anonHugePagesBytes() const { return anon_huge_pages * 1024; }
+    size_t pssBytes() const { return pss * 1024; }
+    size_t privateDirtyBytes() const { return private_dirty * 1024; }
+};
+
+// Cumulative rounding slack (usable - requested bytes) per power of two
+// size class, class `c` holds requests in [2^c, 2^(c+1)). Every block is
+// counted once, in the class of its latest size
+class SlackHistogram {
+  public:
+    static constexpr size_t CLASSES = 64;
+
+    size_t allocations[CLASSES] = {};
+    size_t requested_bytes[CLASSES] = {};
+    size_t usable_bytes[CLASSES] = {};
+
+    SlackHistogram() = default;
+
+    static size_t sizeClass(size_t size) {
+        return (size > 0) ? (size_t)(63 - __builtin_clzll(size)) : 0;
+    }
+
+    void add(size_t requested, size_t usable) {
+        size_t c = sizeClass(requested);
+        allocations[c]++;
+        requested_bytes[c] += requested;
+        usable_bytes[c] += usable;
+    }
+
+    // Move the block from the class of its old size to the one of its new
+    // size. Counts of a single shard may wrap when the block was allocated
+    // on another one, the merged sums are still right
+    void resize(size_t old_requested, size_t old_usable, size_t requested,
+                size_t usable) {
+        size_t c = sizeClass(old_requested);
+        allocations[c]--;
+        requested_bytes[c] -= old_requested;
+        usable_bytes[c] -= old_usable;
+        add(requested, usable);
+    }
+
+    void writeHeader(std::ostream& os) const;
+    void write(std::ostream& os) const;
+};
+
+// Whole process heap usage, only available when the binary runs with
+// LD_PRELOAD=build/libcpp-shim.so. Everything reads 0 otherwise
+class HeapStats {
+  public:
+    ShimStats shim = {};
+    bool active = false;
+
+    HeapStats() = default;
+
+    bool readFromShim();
+
+    size_t liveBytes() const {
+        return (shim.allocated_bytes >= shim.freed_bytes)
+                   ? (shim.allocated_bytes - shim.freed_bytes)
+                   : 0;
+    }
+};
+
+// Counter with a single writer (the owning thread) and any number of
+// readers. Relaxed load + store, no read-modify-write on the hot path
+class Counter {
+private:
+    std::atomic<int64_t> value_{0};
+
+public:
+    void add(int64_t delta) {
+        value_.store(value_.load(std::memory_order_relaxed) + delta,
+                     std::memory_order_relaxed);
+    }
+    void set(int64_t value) { value_.store(value, std::memory_order_relaxed); }
+    int64_t get() const { return value_.load(std::memory_order_relaxed); }
+};
+
+// Per-thread part of the tracker. Blocks freed on another thread than
+// they were allocated on make `current_*` of a single shard negative,
+// only the sum over all shards is meaningful
+struct Shard {
+    Counter peak_size_allocated;
+    Counter total_size_allocated;
+    Counter total_number_of_allocations;
+    Counter current_size_allocated;
+    Counter current_number_of_allocations;
+    Counter freed_allocation_size;
+    Counter total_number_of_resizes;
+    Counter current_usable_size;
+
+    SlackHistogram slack_histogram;
+
+    void reset();
+};
+
+// Counters of one allocation site (`--sites`). Only the thread working
+// on the sites writes them
+struct SiteStats {
+    Counter allocations;
+    Counter frees;
+    Counter resizes;
+    Counter current_size;
+    Counter current_count;
+    Counter peak_size;
+};
+
+enum EventKind : uint32_t { EVENT_ALLOC, EVENT_FREE, EVENT_RESIZE };
+
+// Accounting request recorded on the allocating thread and applied later
+// by the aggregator (`--tracking async`)
+struct Event {
+    uint64_t timestamp_ns;
+    size_t size;
+    size_t usable;
+    size_t old_size;   // EVENT_RESIZE only
+    size_t old_usable; // EVENT_RESIZE only
+    uint32_t thread;
+    uint32_t kind;
+};
+
+// Per-thread event ring, the owner is the only producer and the aggregator
+// the only consumer
+struct EventSource {
+    concurrent::SpscRing<Event> ring;
+    uint32_t thread;
+    Counter waits;   // pushes that found the ring full and spun
+    Counter dropped; // events lost because the ring was full
+
+    EventSource(size_t capacity, uint32_t id) : ring(capacity), thread(id) {}
+};
+
 class Tracker {
 private:
+    static constexpr size_t MAX_EVENT_SOURCES = 256;
+
+    // Sum of all shards at the last snapshot
     size_t peak_size_allocated_ = 0;
     size_t total_size_allocated_ = 0;
     size_t total_number_of_allocations_ = 0;
     size_t current_size_allocated_ = 0;
     size_t current_number_of_allocations_ = 0;
     size_t freed_allocation_size_ = 0;
+    size_t total_number_of_resizes_ = 0;
+    size_t current_usable_size_ = 0;
+    size_t baseline_rss_ = 0;
+
+    std::mutex shards_mutex_;
+    std::deque<Shard> shards_; // deque keeps shard addresses stable
+    bool sample_on_alloc_ = true;
+    bool usable_size_ = false;
     
     SystemMemoryStats system_stats_;
+    ProcessStats process_stats_;
+    HeapStats heap_stats_;
+
+    // Async tracking: workers only push events, one aggregator thread
+    // applies them to `async_shard_`
+    Tracking tracking_ = TRACKING_INLINE;
+    size_t event_ring_ = 0;
+    std::unique_ptr<EventSource> sources_[MAX_EVENT_SOURCES];
+    std::atomic<size_t> source_count_{0};
+    Shard *async_shard_ = nullptr;
+    std::mutex drain_mutex_; // whoever drains is the single consumer
+    std::thread aggregator_;
+    std::atomic<bool> aggregator_stop_{false};
+    Counter events_applied_;
+    Counter event_lag_max_ns_;
+
+    // Allocation sites, `site_` is charged for every alloc, free and resize
+    std::deque<SiteStats> sites_;
+    size_t site_ = NO_SITE;
+
+    EventSource *eventSource();
+    bool record(const Event &event);
+    size_t drain();
+    static void applyEvent(Shard &s, const Event &event);
+    void chargeSite(const Event &event);
     
     void updateSystemStats() {
-        system_stats_.readFromProc();
+        if (sample_on_alloc_) {
+            system_stats_.readFromProc();
+        }
     }
 
+    Shard &shard();
+
 public:
     static Tracker &instance();
     Tracker() = default;
     
     void init();
+
+    // With several threads /proc is only read when a snapshot is taken,
+    // otherwise every allocating thread would race on the system stats
+    void setSampleOnAlloc(bool sample) { sample_on_alloc_ = sample; }
+
+    // Counters of the calling thread only, for per-worker reports
+    const Shard &threadShard() { return shard(); }
+
+    // Switch accounting mode, call while no worker threads run. Going back
+    // to TRACKING_INLINE stops the aggregator after draining every ring
+    void setTracking(Tracking mode, size_t ring_size);
     
-    void addAlloc(size_t size);
-    void removeAlloc(size_t size);
+    static constexpr size_t NO_SITE = ~(size_t)0;
+
+    // Per-site accounting, every alloc, free and resize until the next
+    // `setSite` belongs to `site`. Frees have to happen inline (--reclaim
+    // immediate) to be charged to the right site
+    void setSites(size_t count);
+    void setSite(size_t site) { site_ = site; }
+    size_t siteCount() const { return sites_.size(); }
+    const SiteStats &siteStats(size_t site) const { return sites_[site]; }
+
+    // Ask the backend what it really reserved for every block, only worth
+    // a malloc_usable_size per operation when the slack is written out
+    void setUsableSize(bool enabled) { usable_size_ = enabled; }
+    size_t usableSize(void *p, size_t size) const {
+        return usable_size_ ? backend::usable_size(p, size) : size;
+    }
+
+    // `usable` is what the backend really reserved for the block
+    void addAlloc(size_t size, size_t usable);
+    void removeAlloc(size_t size, size_t usable);
+    void resizeAlloc(size_t old_size, size_t new_size, size_t old_usable, size_t new_usable);
+
+    /// @brief Sum shard counters. With one shard the peak is exact, with
+    ///        more it is sampled at every merge
+    void merge();
     
     void writeHeader(std::ostream& os) const;
-    void write(std::ostream& os) const;
+    void write(std::ostream& os);
+    void writeSlackHistogram(std::ostream& os);
     
     void printDebug() const;
     
     double memoryEfficiency() const;
     size_t memoryOverheadBytes() const;
     
+    // Values as of the last `merge` (or `write`)
     size_t peakSizeAllocated() const { return peak_size_allocated_; }
     size_t totalSizeAllocated() const { return total_size_allocated_; }
     size_t totalNumberOfAllocations() const { return total_number_of_allocations_; }
     size_t currentSizeAllocated() const { return current_size_allocated_; }
     size_t currentNumberOfAllocations() const { return current_number_of_allocations_; }
     size_t freedAllocationSize() const { return freed_allocation_size_; }
+    size_t totalNumberOfResizes() const { return total_number_of_resizes_; }
+    size_t currentUsableSize() const { return current_usable_size_; }
+    size_t baselineRss() const { return baseline_rss_; }
     const SystemMemoryStats& systemStats() const { return system_stats_; }
+    const ProcessStats& processStats() const { return process_stats_; }
+    const HeapStats& heapStats() const { return heap_stats_; }
 };
 
 template <typename T> class TrackingAllocator {
@@ -110,14 +350,28 @@ template <typename T> class TrackingAllocator {
 
     pointer allocate(size_type n) {
         std::size_t bytes = n * sizeof(T);
-        Tracker::instance().addAlloc(bytes);
-        return static_cast<T *>(
-            ::operator new(bytes)); // match with ::operator delete
+        void *p = backend::allocate(bytes); // match with backend::deallocate
+        Tracker &tracker = Tracker::instance();
+        tracker.addAlloc(bytes, tracker.usableSize(p, bytes));
+        return static_cast<T *>(p);
     }
 
     void deallocate(pointer p, size_type n) noexcept {
-        Tracker::instance().removeAlloc(n * sizeof(T));
-        ::operator delete(p); // DO NOT use delete[] or std::free here
+        std::size_t bytes = n * sizeof(T);
+        Tracker &tracker = Tracker::instance();
+        tracker.removeAlloc(bytes, tracker.usableSize(p, bytes));
+        backend::deallocate(p, bytes); // size picks the backend path
+    }
+
+    pointer reallocate(pointer p, size_type old_n, size_type new_n) {
+        std::size_t old_bytes = old_n * sizeof(T);
+        std::size_t new_bytes = new_n * sizeof(T);
+        Tracker &tracker = Tracker::instance();
+        std::size_t old_usable = tracker.usableSize(p, old_bytes);
+        void *q = backend::reallocate(p, old_bytes, new_bytes);
+        tracker.resizeAlloc(old_bytes, new_bytes, old_usable,
+                            tracker.usableSize(q, new_bytes));
+        return static_cast<T *>(q);
     }
 
     template <typename U>
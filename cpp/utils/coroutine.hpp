@@ -0,0 +1,64 @@
+#ifndef COROUTINE_HPP
+#define COROUTINE_HPP
+
+#include "common.hpp"
+
+#include <coroutine>
+#include <exception>
+
+namespace utils {
+
+/// Coroutine driven by hand with `resume`. It is suspended before the body
+/// starts and at every `co_await std::suspend_always{}`, the frame lives
+/// until the object is destroyed
+class Coroutine {
+  public:
+    struct promise_type {
+        Coroutine get_return_object() {
+            return Coroutine(handle_type::from_promise(self));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    using handle_type = std::coroutine_handle<promise_type>;
+
+  private:
+    handle_type handle;
+
+    explicit Coroutine(handle_type h) : handle(h) {}
+
+  public:
+    Coroutine(const Coroutine &) = delete;
+    Coroutine &operator=(const Coroutine &) = delete;
+
+    Coroutine(Coroutine &&other) noexcept : handle(other.handle) {
+        other.handle = nullptr;
+    }
+
+    Coroutine &operator=(Coroutine &&other) noexcept {
+        if (this != &other) {
+            if (self.handle) {
+                self.handle.destroy();
+            }
+            self.handle = other.handle;
+            other.handle = nullptr;
+        }
+        return self;
+    }
+
+    ~Coroutine() {
+        if (self.handle) {
+            self.handle.destroy();
+        }
+    }
+
+    void resume() { self.handle.resume(); }
+    bool done() const { return self.handle.done(); }
+};
+
+} // namespace utils
+
+#endif // COROUTINE_HPP
@@ -123,8 +123,10 @@ void ProgressBar::draw() const {
     std::cout.flush();
 }
 
-void ProgressBar::update() {
-    current++;
+void ProgressBar::update() { update_to(current + 1); }
+
+void ProgressBar::update_to(usize current) {
+    self.current = current;
 
     auto now = std::chrono::steady_clock::now();
 
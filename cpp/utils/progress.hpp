@@ -36,6 +36,7 @@ class ProgressBar {
     }
 
     void update();
+    void update_to(usize current);
     bool is_finished() const;
     void finish();
 